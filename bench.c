@@ -0,0 +1,1339 @@
+/**
+ * bench.c version 5.11
+ *
+ * The program that measures the performance of specialized komihash
+ * functions, versus the equivalent use of the komihash() function. The name
+ * of a single benchmark to run can be passed as an argument; all benchmarks
+ * are run otherwise. Each figure is the best of several runs. Results depend
+ * on the compiler, its options, and the processor, and should be compared on
+ * the same system. Requires C11 (for the `timespec_get()` function).
+ * Multi-threaded functions are benchmarked if the KOMIHASH_PTHREADS macro is
+ * defined (e.g., via `-DKOMIHASH_PTHREADS -pthread` options).
+ *
+ * Description is available at https://github.com/avaneev/komihash
+ *
+ * License
+ *
+ * Copyright (c) 2021-2024 Aleksey Vaneev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "komihash.h"
+
+#if defined( KOMIHASH_PTHREADS )
+	#include <unistd.h>
+#endif // defined( KOMIHASH_PTHREADS )
+
+static volatile uint64_t bench_sink; // Keeps results from being optimized out.
+
+/**
+ * @brief Returns the current wall-clock time, in seconds.
+ */
+
+static double bench_time()
+{
+	struct timespec ts;
+	timespec_get( &ts, TIME_UTC );
+
+	return( (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9 );
+}
+
+/**
+ * @def BENCH_MIN( t, code )
+ * @brief Macro runs the `code` several times, and stores the smallest
+ * run time, in seconds, to `t`.
+ */
+
+#define BENCH_MIN( t, code ) \
+	{ \
+		int bench_k; \
+		t = 1e30; \
+		for( bench_k = 0; bench_k < 5; bench_k++ ) \
+		{ \
+			const double bench_t0 = bench_time(); \
+			code \
+			const double bench_t1 = bench_time() - bench_t0; \
+			t = ( bench_t1 < t ? bench_t1 : t ); \
+		} \
+	}
+
+/**
+ * @brief Fills a buffer with pseudo-random bytes, produced by komirand().
+ */
+
+static void bench_fill( uint8_t* const p, const size_t l )
+{
+	uint64_t Seed1 = 1;
+	uint64_t Seed2 = 2;
+	size_t i;
+
+	for( i = 0; i < l; i++ )
+	{
+		p[ i ] = (uint8_t) komirand( &Seed1, &Seed2 );
+	}
+}
+
+/**
+ * @brief Hashing of keys with padding after them (komihash_padded()),
+ * versus komihash(), with fixed and random key lengths.
+ */
+
+static void bench_padded()
+{
+	#define padn 4096
+	#define padr 300
+	static uint8_t keys[ padn * 48 ];
+	static size_t lens[ padn ];
+	static uint64_t hashes[ padn ];
+
+	#define padlc 4
+	const int padlo[ padlc ] = { 8, 24, 0, 0 };
+	const int padhi[ padlc ] = { 8, 24, 15, 31 };
+	uint64_t Seed1 = 3;
+	uint64_t Seed2 = 4;
+	double t1, t2;
+	int i, j, r;
+
+	bench_fill( keys, sizeof( keys ));
+
+	for( j = 0; j < padlc; j++ )
+	{
+		for( i = 0; i < padn; i++ )
+		{
+			lens[ i ] = (size_t) ( padlo[ j ] + (int) ( komirand( &Seed1,
+				&Seed2 ) % (uint64_t) ( padhi[ j ] - padlo[ j ] + 1 )));
+		}
+
+		BENCH_MIN( t1,
+			for( r = 0; r < padr; r++ )
+			{
+				for( i = 0; i < padn; i++ )
+				{
+					hashes[ i ] = komihash( keys + i * 48, lens[ i ], r );
+				}
+
+				bench_sink += hashes[ r ];
+			}
+		)
+
+		BENCH_MIN( t2,
+			for( r = 0; r < padr; r++ )
+			{
+				for( i = 0; i < padn; i++ )
+				{
+					hashes[ i ] = komihash_padded( keys + i * 48, lens[ i ],
+						r );
+				}
+
+				bench_sink += hashes[ r ];
+			}
+		)
+
+		printf( "padded(%i-%i): komihash() %.2f ns/key, komihash_padded() "
+			"%.2f ns/key\n", padlo[ j ], padhi[ j ], t1 * 1e9 / padn / padr,
+			t2 * 1e9 / padn / padr );
+	}
+
+	printf( "\n" );
+}
+
+/**
+ * @brief Interleaved hashing of 4 independent 0-63-byte messages, with the
+ * same seed (reference implementation for the "batch" benchmark).
+ *
+ * Produces values equal to those of komihash(). All three possible 16-byte
+ * rounds are performed for every message, with the results of unneeded
+ * rounds discarded via masking, so that the hashing of all messages is
+ * interleaved without length-dependent branching. Each message should be
+ * preceded by 8 readable bytes, and followed by 64 readable bytes.
+ */
+
+static void bench_batch4( const uint8_t* const* const Msgs,
+	const size_t* const MsgLens, const uint64_t UseSeed, uint64_t* const out )
+{
+	KOMIHASH_SEEDINIT();
+
+	uint64_t S1[ 4 ], S5[ 4 ], r1h[ 4 ], r2h[ 4 ];
+	int j;
+
+	KOMIHASH_MULTI_EACH( 4,
+		S1[ j ] = Seed1;
+		S5[ j ] = Seed5; );
+
+	#define BENCH_BATCH_ROUND( r ) \
+		KOMIHASH_MULTI_EACH( 4, \
+			const uint8_t* const m = Msgs[ j ] + r * 16; \
+			const uint64_t rm = (uint64_t) 0 - \
+				(uint64_t) ( MsgLens[ j ] >> 4 > r ); \
+			uint64_t s1; \
+			uint64_t s5 = S5[ j ]; \
+			kh_m128( S1[ j ] ^ kh_lu64ec( m ), s5 ^ kh_lu64ec( m + 8 ), \
+				&s1, &s5 ); \
+			s1 ^= s5; \
+			S1[ j ] = ( s1 & rm ) | ( S1[ j ] & ~rm ); \
+			S5[ j ] = ( s5 & rm ) | ( S5[ j ] & ~rm ); )
+
+	BENCH_BATCH_ROUND( 0 );
+	BENCH_BATCH_ROUND( 1 );
+	BENCH_BATCH_ROUND( 2 );
+
+	#undef BENCH_BATCH_ROUND
+
+	KOMIHASH_MULTI_EACH( 4,
+		const size_t l = MsgLens[ j ];
+		const size_t tl = l & 15;
+		const uint8_t* const m = Msgs[ j ] + ( l - tl );
+
+		r1h[ j ] = S1[ j ];
+		r2h[ j ] = S5[ j ];
+
+		if( tl > 7 )
+		{
+			r2h[ j ] ^= kh_lpu64ec_l4( m + 8, tl - 8 );
+			r1h[ j ] ^= kh_lu64ec( m );
+		}
+		else
+		if( l != 0 )
+		{
+			r1h[ j ] ^= kh_lpu64ec_l4( m, tl );
+		} );
+
+	KOMIHASH_MULTI_EACH( 4,
+		kh_m128( r1h[ j ], r2h[ j ], &S1[ j ], &S5[ j ]);
+		S1[ j ] ^= S5[ j ]; );
+
+	KOMIHASH_MULTI_EACH( 4,
+		kh_m128( S1[ j ], S5[ j ], &S1[ j ], &S5[ j ]);
+		out[ j ] = S1[ j ] ^ S5[ j ]; );
+}
+
+/**
+ * @brief Hashing of independent short keys via a loop of komihash() calls,
+ * versus interleaved hashing of 4 keys at a time (bench_batch4()), and
+ * versus komihash_padded(), with fixed and random key lengths.
+ */
+
+static void bench_batch()
+{
+	#define batchn 4096
+	#define batchr 300
+	static uint8_t keys[ batchn * 128 ];
+	static const uint8_t* ptrs[ batchn ];
+	static size_t lens[ batchn ];
+	static uint64_t hashes[ batchn ];
+
+	#define batchlc 4
+	const int batchlo[ batchlc ] = { 8, 24, 0, 16 };
+	const int batchhi[ batchlc ] = { 8, 24, 63, 63 };
+	uint64_t Seed1 = 7;
+	uint64_t Seed2 = 8;
+	double t1, t2, t3;
+	int i, j, r;
+
+	bench_fill( keys, sizeof( keys ));
+
+	for( i = 0; i < batchn; i++ )
+	{
+		ptrs[ i ] = keys + i * 128 + 8;
+	}
+
+	for( j = 0; j < batchlc; j++ )
+	{
+		for( i = 0; i < batchn; i++ )
+		{
+			lens[ i ] = (size_t) ( batchlo[ j ] + (int) ( komirand( &Seed1,
+				&Seed2 ) % (uint64_t) ( batchhi[ j ] - batchlo[ j ] + 1 )));
+		}
+
+		for( i = 0; i < batchn; i += 4 )
+		{
+			bench_batch4( ptrs + i, lens + i, 0, hashes + i );
+		}
+
+		for( i = 0; i < batchn; i++ )
+		{
+			if( hashes[ i ] != komihash( ptrs[ i ], lens[ i ], 0 ))
+			{
+				printf( "batch: bench_batch4() mismatch\n" );
+				return;
+			}
+		}
+
+		BENCH_MIN( t1,
+			for( r = 0; r < batchr; r++ )
+			{
+				for( i = 0; i < batchn; i++ )
+				{
+					hashes[ i ] = komihash( ptrs[ i ], lens[ i ], r );
+				}
+
+				bench_sink += hashes[ r ];
+			}
+		)
+
+		BENCH_MIN( t2,
+			for( r = 0; r < batchr; r++ )
+			{
+				for( i = 0; i < batchn; i += 4 )
+				{
+					bench_batch4( ptrs + i, lens + i, (uint64_t) r,
+						hashes + i );
+				}
+
+				bench_sink += hashes[ r ];
+			}
+		)
+
+		BENCH_MIN( t3,
+			for( r = 0; r < batchr; r++ )
+			{
+				for( i = 0; i < batchn; i++ )
+				{
+					hashes[ i ] = komihash_padded( ptrs[ i ], lens[ i ], r );
+				}
+
+				bench_sink += hashes[ r ];
+			}
+		)
+
+		printf( "batch(%i-%i): komihash() %.2f ns/key, interleaved %.2f "
+			"ns/key, komihash_padded() %.2f ns/key\n", batchlo[ j ],
+			batchhi[ j ], t1 * 1e9 / batchn / batchr,
+			t2 * 1e9 / batchn / batchr, t3 * 1e9 / batchn / batchr );
+	}
+
+	printf( "\n" );
+}
+
+/**
+ * @brief Hashing of large messages (komihash_bulk()), versus komihash(), at
+ * 1 MB (cache-bound), 64 MB and 4 GB (DRAM-bound) message lengths. The 4 GB
+ * length is skipped if memory cannot be allocated.
+ */
+
+static void bench_bulk()
+{
+	#define bulkc 3
+	const double bulkl[ bulkc ] = { 1048576.0, 67108864.0, 4294967296.0 };
+	double t1, t2;
+	int j, r;
+
+	printf( "KOMIHASH_BULK_PFDIST = %i, KOMIHASH_BULK_PFLOC = %i\n",
+		KOMIHASH_BULK_PFDIST, KOMIHASH_BULK_PFLOC );
+
+	for( j = 0; j < bulkc; j++ )
+	{
+		if( bulkl[ j ] > (double) (size_t) -1 )
+		{
+			continue;
+		}
+
+		const size_t l = (size_t) bulkl[ j ];
+		uint8_t* const p = (uint8_t*) malloc( l );
+
+		if( p == 0 )
+		{
+			printf( "bulk(%.0f MB): cannot allocate\n", bulkl[ j ] / 1048576 );
+			continue;
+		}
+
+		size_t i;
+		bench_fill( p, 1048576 );
+
+		for( i = 1048576; i < l; i += 1048576 )
+		{
+			memcpy( p + i, p, 1048576 );
+			p[ i ] = (uint8_t) ( i >> 20 );
+		}
+
+		// About 1 GB is hashed per run.
+
+		const int rc = ( l < 1073741824 ? (int) ( 1073741824 / l ) : 1 );
+
+		BENCH_MIN( t1,
+			for( r = 0; r < rc; r++ )
+			{
+				bench_sink += komihash( p, l, r );
+			}
+		)
+
+		BENCH_MIN( t2,
+			for( r = 0; r < rc; r++ )
+			{
+				bench_sink += komihash_bulk( p, l, r );
+			}
+		)
+
+		printf( "bulk(%.0f MB): komihash() %.1f GB/s, komihash_bulk() "
+			"%.1f GB/s\n", bulkl[ j ] / 1048576, bulkl[ j ] * rc / t1 * 1e-9,
+			bulkl[ j ] * rc / t2 * 1e-9 );
+
+		free( p );
+	}
+
+	printf( "\n" );
+}
+
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+
+/**
+ * @brief The komihash_bulk() function, compiled for BMI2 and ADX
+ * instruction sets (reference implementation for the "kernel" benchmark).
+ *
+ * The compiler lowers the `kh_m128()` function's 128-bit multiplication to
+ * the `MULX` instruction. Produces values equal to those of komihash().
+ */
+
+__attribute__(( target( "bmi2,adx" )))
+static uint64_t bench_bulk_bmi2( const void* const Msg0, size_t MsgLen,
+	const uint64_t UseSeed )
+{
+	const uint8_t* Msg = (const uint8_t*) Msg0;
+	komihash_key_t key;
+
+	komihash_key_init( &key, UseSeed );
+
+	kh_loop64_body( &Msg, &MsgLen, key.Seed );
+
+	const uint64_t Seed5 = key.Seed[ 4 ] ^ key.Seed[ 5 ] ^ key.Seed[ 6 ] ^
+		key.Seed[ 7 ];
+
+	const uint64_t Seed1 = key.Seed[ 0 ] ^ key.Seed[ 1 ] ^ key.Seed[ 2 ] ^
+		key.Seed[ 3 ];
+
+	return( komihash_epi( Msg, MsgLen, Seed1, Seed5 ));
+}
+
+/**
+ * @brief Throughput of the portable komihash_bulk() kernel, versus the same
+ * kernel compiled for BMI2 and ADX (bench_bulk_bmi2()), at 1 MB
+ * (cache-bound) and 64 MB (DRAM-bound) message lengths. Skipped if the
+ * processor does not support BMI2 and ADX.
+ */
+
+static void bench_kernel()
+{
+	#define kernc 2
+	const size_t kernl[ kernc ] = { 1048576, 67108864 };
+	double t1, t2;
+	int j, r;
+
+	if( !__builtin_cpu_supports( "bmi2" ) || !__builtin_cpu_supports( "adx" ))
+	{
+		printf( "kernel: BMI2 or ADX is not supported\n\n" );
+		return;
+	}
+
+	for( j = 0; j < kernc; j++ )
+	{
+		const size_t l = kernl[ j ];
+		uint8_t* const p = (uint8_t*) malloc( l );
+
+		if( p == 0 )
+		{
+			printf( "kernel: cannot allocate\n\n" );
+			return;
+		}
+
+		bench_fill( p, l );
+
+		if( bench_bulk_bmi2( p, l, 0 ) != komihash( p, l, 0 ))
+		{
+			printf( "kernel: bench_bulk_bmi2() mismatch\n\n" );
+			free( p );
+			return;
+		}
+
+		// About 512 MB is hashed per run.
+
+		const int rc = (int) ( 536870912 / l );
+
+		BENCH_MIN( t1,
+			for( r = 0; r < rc; r++ )
+			{
+				bench_sink += komihash_bulk( p, l, r );
+			}
+		)
+
+		BENCH_MIN( t2,
+			for( r = 0; r < rc; r++ )
+			{
+				bench_sink += bench_bulk_bmi2( p, l, (uint64_t) r );
+			}
+		)
+
+		printf( "kernel(%i MB): portable %.1f GB/s, BMI2/ADX %.1f GB/s\n",
+			(int) ( l >> 20 ), (double) l * rc / t1 * 1e-9,
+			(double) l * rc / t2 * 1e-9 );
+
+		free( p );
+	}
+
+	printf( "\n" );
+}
+
+#endif // defined( __x86_64__ ) && defined( __GNUC__ )
+
+/**
+ * @brief Hashing of 20-field rows (6 `uint64_t`, 6 `uint32_t`, 4 `uint16_t`,
+ * 4 `uint8_t` fields) via typed appends (komihash_stream_update_u64() and
+ * others), versus per-field komihash_stream_update() calls.
+ */
+
+static void bench_row()
+{
+	#define rown 4096
+	#define rowr 50
+	static uint64_t f64[ rown ][ 6 ];
+	static uint32_t f32[ rown ][ 6 ];
+	static uint16_t f16[ rown ][ 4 ];
+	static uint8_t f8[ rown ][ 4 ];
+	static uint64_t hashes[ rown ];
+
+	komihash_stream_t ctx;
+	double t1, t2;
+	int i, j, r;
+
+	bench_fill( (uint8_t*) f64, sizeof( f64 ));
+	bench_fill( (uint8_t*) f32, sizeof( f32 ));
+	bench_fill( (uint8_t*) f16, sizeof( f16 ));
+	bench_fill( f8[ 0 ], sizeof( f8 ));
+
+	BENCH_MIN( t1,
+		for( r = 0; r < rowr; r++ )
+		{
+			for( i = 0; i < rown; i++ )
+			{
+				komihash_stream_init( &ctx, r );
+
+				for( j = 0; j < 6; j++ )
+				{
+					komihash_stream_update( &ctx, &f64[ i ][ j ], 8 );
+					komihash_stream_update( &ctx, &f32[ i ][ j ], 4 );
+				}
+
+				for( j = 0; j < 4; j++ )
+				{
+					komihash_stream_update( &ctx, &f16[ i ][ j ], 2 );
+					komihash_stream_update( &ctx, &f8[ i ][ j ], 1 );
+				}
+
+				hashes[ i ] = komihash_stream_final( &ctx );
+			}
+
+			bench_sink += hashes[ r ];
+		}
+	)
+
+	BENCH_MIN( t2,
+		for( r = 0; r < rowr; r++ )
+		{
+			for( i = 0; i < rown; i++ )
+			{
+				komihash_stream_init( &ctx, r );
+
+				for( j = 0; j < 6; j++ )
+				{
+					komihash_stream_update_u64( &ctx, f64[ i ][ j ]);
+					komihash_stream_update_u32( &ctx, f32[ i ][ j ]);
+				}
+
+				for( j = 0; j < 4; j++ )
+				{
+					komihash_stream_update_u16( &ctx, f16[ i ][ j ]);
+					komihash_stream_update_u8( &ctx, f8[ i ][ j ]);
+				}
+
+				hashes[ i ] = komihash_stream_final( &ctx );
+			}
+
+			bench_sink += hashes[ r ];
+		}
+	)
+
+	printf( "row(20 fields): komihash_stream_update() %.1f ns/row, "
+		"typed appends %.1f ns/row\n\n", t1 * 1e9 / rown / rowr,
+		t2 * 1e9 / rown / rowr );
+}
+
+/**
+ * @brief Hashing of 20-byte suffixes of an 800-byte prefix
+ * (komihash_from_prefix()), versus komihash() of whole keys; and hashing of
+ * 128 prefixes of a 2048-byte message (komihash_prefixes()), versus
+ * komihash() of each prefix.
+ */
+
+static void bench_prefix()
+{
+	#define prefn 4096
+	#define prefr 50
+	static uint8_t keys[ prefn ][ 820 ];
+	static uint64_t hashes[ prefn ];
+	static size_t Cuts[ 128 ];
+
+	komihash_prefix_t ps;
+	double t1, t2;
+	int i, r;
+
+	bench_fill( keys[ 0 ], sizeof( keys ));
+
+	for( i = 1; i < prefn; i++ )
+	{
+		memcpy( keys[ i ], keys[ 0 ], 800 );
+	}
+
+	komihash_prefix_init( &ps, keys[ 0 ], 800, 0 );
+
+	BENCH_MIN( t1,
+		for( r = 0; r < prefr; r++ )
+		{
+			for( i = 0; i < prefn; i++ )
+			{
+				hashes[ i ] = komihash( keys[ i ], 820, 0 );
+			}
+
+			bench_sink += hashes[ r ];
+		}
+	)
+
+	BENCH_MIN( t2,
+		for( r = 0; r < prefr; r++ )
+		{
+			for( i = 0; i < prefn; i++ )
+			{
+				hashes[ i ] = komihash_from_prefix( &ps, keys[ i ] + 800, 20 );
+			}
+
+			bench_sink += hashes[ r ];
+		}
+	)
+
+	printf( "prefix(800+20): komihash() %.1f ns/key, komihash_from_prefix() "
+		"%.1f ns/key\n", t1 * 1e9 / prefn / prefr, t2 * 1e9 / prefn / prefr );
+
+	for( i = 0; i < 128; i++ )
+	{
+		Cuts[ i ] = (size_t) ( i + 1 ) * 16;
+	}
+
+	BENCH_MIN( t1,
+		for( r = 0; r < prefr * 10; r++ )
+		{
+			for( i = 0; i < 128; i++ )
+			{
+				hashes[ i ] = komihash( keys[ 1 ], Cuts[ i ], r );
+			}
+
+			bench_sink += hashes[ r & 127 ];
+		}
+	)
+
+	BENCH_MIN( t2,
+		for( r = 0; r < prefr * 10; r++ )
+		{
+			komihash_prefixes( keys[ 1 ], 2048, Cuts, 128, r, hashes );
+			bench_sink += hashes[ r & 127 ];
+		}
+	)
+
+	printf( "prefix(2048, 128 cuts): komihash() %.2f us, komihash_prefixes() "
+		"%.2f us\n\n", t1 * 1e6 / prefr / 10, t2 * 1e6 / prefr / 10 );
+}
+
+/**
+ * @brief ASCII case-insensitive hashing (komihash_ci()) of 24-byte keys and
+ * 4096-byte messages, versus a lowercase copy followed by komihash().
+ */
+
+static void bench_ci()
+{
+	#define cin 4096
+	#define cic 2
+	const size_t cil[ cic ] = { 24, 4096 };
+	static uint8_t p[ cin + 4096 ];
+	uint8_t lc[ 4096 ];
+	double t1, t2;
+	size_t i, k;
+	int j;
+
+	bench_fill( p, sizeof( p ));
+
+	for( i = 0; i < sizeof( p ); i++ )
+	{
+		p[ i ] = (uint8_t) ( 'A' + p[ i ] % 58 ); // Mixed-case letters.
+	}
+
+	for( j = 0; j < cic; j++ )
+	{
+		const size_t l = cil[ j ];
+		const size_t rc = ( l < 256 ? cin * 64 : cin );
+
+		BENCH_MIN( t1,
+			for( i = 0; i < rc; i++ )
+			{
+				const uint8_t* const m = p + ( i & ( cin - 1 ));
+
+				for( k = 0; k < l; k++ )
+				{
+					lc[ k ] = (uint8_t) ( (unsigned int) ( m[ k ] - 'A' ) < 26 ?
+						m[ k ] + 32 : m[ k ]);
+				}
+
+				bench_sink += komihash( lc, l, 0 );
+			}
+		)
+
+		BENCH_MIN( t2,
+			for( i = 0; i < rc; i++ )
+			{
+				bench_sink += komihash_ci( p + ( i & ( cin - 1 )), l, 0 );
+			}
+		)
+
+		printf( "ci(%i): copy and komihash() %.1f ns, komihash_ci() %.1f ns\n",
+			(int) l, t1 * 1e9 / rc, t2 * 1e9 / rc );
+	}
+
+	printf( "\n" );
+}
+
+/**
+ * @brief Hashing of a message with 4 seeds (komihash_multi()), versus 4
+ * komihash() calls, at 8, 48 and 4096 byte message lengths. Figures are
+ * nanoseconds per 4 hash values.
+ */
+
+static void bench_multi()
+{
+	#define multic 3
+	const size_t multil[ multic ] = { 8, 48, 4096 };
+	static uint8_t p[ 4096 ];
+	uint64_t Seeds[ 4 ] = { 1, 2, 3, 4 };
+	uint64_t h[ 4 ];
+	double t1, t2;
+	int j, r;
+
+	bench_fill( p, sizeof( p ));
+
+	for( j = 0; j < multic; j++ )
+	{
+		const size_t l = multil[ j ];
+
+		// About 64 MB is hashed per run, per seed.
+
+		const int rc = (int) ( 67108864 / ( l + 64 ));
+
+		BENCH_MIN( t1,
+			for( r = 0; r < rc; r++ )
+			{
+				Seeds[ 0 ] = (uint64_t) r;
+
+				bench_sink += komihash( p, l, Seeds[ 0 ]) ^
+					komihash( p, l, Seeds[ 1 ]) ^
+					komihash( p, l, Seeds[ 2 ]) ^
+					komihash( p, l, Seeds[ 3 ]);
+			}
+		)
+
+		BENCH_MIN( t2,
+			for( r = 0; r < rc; r++ )
+			{
+				Seeds[ 0 ] = (uint64_t) r;
+
+				komihash_multi( p, l, Seeds, 4, h );
+				bench_sink += h[ 0 ] ^ h[ 1 ] ^ h[ 2 ] ^ h[ 3 ];
+			}
+		)
+
+		printf( "multi(%i): 4 komihash() calls %.1f ns, komihash_multi() "
+			"%.1f ns, x%.2f\n", (int) l, t1 * 1e9 / rc, t2 * 1e9 / rc,
+			t2 / t1 );
+	}
+
+	printf( "\n" );
+}
+
+/**
+ * @brief A plain loop over records, with the seed initialization performed
+ * once, and prefetching KOMIHASH_STRIDED_PFAHEAD records ahead: the
+ * non-interleaved alternative to komihash_strided().
+ */
+
+static void bench_strided_loop( const uint8_t* Msg, const size_t Stride,
+	const size_t FieldLen, size_t Count, const uint64_t UseSeed,
+	uint64_t* out )
+{
+	KOMIHASH_SEEDINIT();
+
+	const size_t FieldLast = FieldLen - ( FieldLen != 0 );
+	const size_t PfDist = Stride * KOMIHASH_STRIDED_PFAHEAD;
+
+	while( Count != 0 )
+	{
+		if( Count > KOMIHASH_STRIDED_PFAHEAD )
+		{
+			KOMIHASH_PREFETCH( Msg + PfDist );
+			KOMIHASH_PREFETCH( Msg + PfDist + FieldLast );
+		}
+
+		*out = komihash_body( Msg, FieldLen, Seed1, Seed5 );
+		Msg += Stride;
+		out++;
+		Count--;
+	}
+}
+
+/**
+ * @brief Hashing of a field of 16384 128-byte records (komihash_strided()),
+ * versus a komihash() loop, and versus a plain loop with the seed
+ * initialization performed once (bench_strided_loop()), at 8, 24, 48 and 100
+ * byte field lengths. Figures are nanoseconds per record.
+ */
+
+static void bench_strided()
+{
+	#define stridedc 4
+	#define stridedn 16384
+	const size_t stridedl[ stridedc ] = { 8, 24, 48, 100 };
+	static uint8_t p[ stridedn * 128 ];
+	static uint64_t h[ stridedn ];
+	double t1, t2, t3;
+	size_t i;
+	int j, r;
+
+	bench_fill( p, sizeof( p ));
+
+	for( j = 0; j < stridedc; j++ )
+	{
+		const size_t l = stridedl[ j ];
+
+		BENCH_MIN( t1,
+			for( r = 0; r < 20; r++ )
+			{
+				for( i = 0; i < stridedn; i++ )
+				{
+					h[ i ] = komihash( p + i * 128 + 8, l, (uint64_t) r );
+				}
+
+				bench_sink += h[ r ];
+			}
+		)
+
+		BENCH_MIN( t2,
+			for( r = 0; r < 20; r++ )
+			{
+				bench_strided_loop( p + 8, 128, l, stridedn, (uint64_t) r,
+					h );
+
+				bench_sink += h[ r ];
+			}
+		)
+
+		BENCH_MIN( t3,
+			for( r = 0; r < 20; r++ )
+			{
+				komihash_strided( p, 128, 8, l, stridedn, (uint64_t) r, h );
+				bench_sink += h[ r ];
+			}
+		)
+
+		printf( "strided(%i): komihash() loop %.1f ns, plain loop %.1f ns, "
+			"komihash_strided() %.1f ns\n", (int) l,
+			t1 * 1e9 / ( 20 * stridedn ), t2 * 1e9 / ( 20 * stridedn ),
+			t3 * 1e9 / ( 20 * stridedn ));
+	}
+
+	printf( "\n" );
+}
+
+/**
+ * @brief 128-bit hashing (komihash128()), versus komihash(), and versus two
+ * komihash() calls with different seeds (a naive 128-bit hash), at 8, 48
+ * and 1024 byte message lengths. Figures are nanoseconds per hash value.
+ */
+
+static void bench_h128()
+{
+	#define h128c 3
+	const size_t h128l[ h128c ] = { 8, 48, 1024 };
+	static uint8_t p[ 1024 ];
+	uint64_t h[ 2 ];
+	double t1, t2, t3;
+	int j, r;
+
+	bench_fill( p, sizeof( p ));
+
+	for( j = 0; j < h128c; j++ )
+	{
+		const size_t l = h128l[ j ];
+		const int rc = (int) ( 67108864 / ( l + 64 ));
+
+		BENCH_MIN( t1,
+			for( r = 0; r < rc; r++ )
+			{
+				bench_sink += komihash( p, l, (uint64_t) r );
+			}
+		)
+
+		BENCH_MIN( t2,
+			for( r = 0; r < rc; r++ )
+			{
+				bench_sink += komihash( p, l, (uint64_t) r ) ^
+					komihash( p, l, ~(uint64_t) r );
+			}
+		)
+
+		BENCH_MIN( t3,
+			for( r = 0; r < rc; r++ )
+			{
+				komihash128( p, l, (uint64_t) r, h );
+				bench_sink += h[ 0 ] ^ h[ 1 ];
+			}
+		)
+
+		printf( "h128(%i): komihash() %.1f ns, 2 komihash() calls %.1f ns, "
+			"komihash128() %.1f ns\n", (int) l, t1 * 1e9 / rc, t2 * 1e9 / rc,
+			t3 * 1e9 / rc );
+	}
+
+	printf( "\n" );
+}
+
+/**
+ * @brief Hashing via the "wide" variant (komihash_wide()), versus
+ * komihash(), at 1 KB, 64 KB and 1 MB (cache-bound) message lengths.
+ */
+
+static void bench_wide()
+{
+	#define widec 3
+	const size_t widel[ widec ] = { 1024, 65536, 1048576 };
+	static uint8_t p[ 1048576 ];
+	double t1, t2;
+	int j, r;
+
+	bench_fill( p, sizeof( p ));
+
+	for( j = 0; j < widec; j++ )
+	{
+		const size_t l = widel[ j ];
+
+		// About 256 MB is hashed per run.
+
+		const int rc = (int) ( 268435456 / l );
+
+		BENCH_MIN( t1,
+			for( r = 0; r < rc; r++ )
+			{
+				bench_sink += komihash( p, l, r );
+			}
+		)
+
+		BENCH_MIN( t2,
+			for( r = 0; r < rc; r++ )
+			{
+				bench_sink += komihash_wide( p, l, r );
+			}
+		)
+
+		printf( "wide(%i KB): komihash() %.1f GB/s, komihash_wide() "
+			"%.1f GB/s\n", (int) ( l >> 10 ), (double) l * rc / t1 * 1e-9,
+			(double) l * rc / t2 * 1e-9 );
+	}
+
+	printf( "\n" );
+}
+
+/**
+ * @brief Folding of fixed-width columns (komihash_column_fold_i64() and
+ * komihash_column_fold_d128()), versus a per-value komihash() loop, without
+ * and with a validity bitmap (random, 50% of null rows).
+ */
+
+static void bench_fold()
+{
+	#define foldn 65536
+	#define foldr 100
+	static int64_t c64[ foldn ];
+	static uint8_t c128[ foldn * 16 ];
+	static uint8_t vb[ foldn / 8 ];
+	static uint64_t h[ foldn ];
+
+	double t1, t2;
+	int i, j, r;
+
+	bench_fill( (uint8_t*) c64, sizeof( c64 ));
+	bench_fill( c128, sizeof( c128 ));
+	bench_fill( vb, sizeof( vb ));
+
+	for( j = 0; j < 2; j++ )
+	{
+		const uint8_t* const v = ( j == 0 ? 0 : vb );
+
+		BENCH_MIN( t1,
+			for( r = 0; r < foldr; r++ )
+			{
+				for( i = 0; i < foldn; i++ )
+				{
+					h[ i ] = ( v == 0 || ( v[ i >> 3 ] >> ( i & 7 ) & 1 ) ?
+						komihash( c64 + i, 8, h[ i ]) :
+						komihash( 0, 0, h[ i ]));
+				}
+			}
+
+			bench_sink += h[ 0 ];
+		)
+
+		BENCH_MIN( t2,
+			for( r = 0; r < foldr; r++ )
+			{
+				komihash_column_fold_i64( c64, foldn, v, h );
+			}
+
+			bench_sink += h[ 0 ];
+		)
+
+		printf( "fold(i64%s): komihash() %.2f ns/row, "
+			"komihash_column_fold_i64() %.2f ns/row\n", ( j == 0 ? "" :
+			", nulls" ), t1 * 1e9 / foldn / foldr, t2 * 1e9 / foldn / foldr );
+
+		BENCH_MIN( t1,
+			for( r = 0; r < foldr; r++ )
+			{
+				for( i = 0; i < foldn; i++ )
+				{
+					h[ i ] = ( v == 0 || ( v[ i >> 3 ] >> ( i & 7 ) & 1 ) ?
+						komihash( c128 + i * 16, 16, h[ i ]) :
+						komihash( 0, 0, h[ i ]));
+				}
+			}
+
+			bench_sink += h[ 0 ];
+		)
+
+		BENCH_MIN( t2,
+			for( r = 0; r < foldr; r++ )
+			{
+				komihash_column_fold_d128( c128, foldn, v, h );
+			}
+
+			bench_sink += h[ 0 ];
+		)
+
+		printf( "fold(d128%s): komihash() %.2f ns/row, "
+			"komihash_column_fold_d128() %.2f ns/row\n", ( j == 0 ? "" :
+			", nulls" ), t1 * 1e9 / foldn / foldr, t2 * 1e9 / foldn / foldr );
+	}
+
+	printf( "\n" );
+}
+
+#if defined( KOMIHASH_PTHREADS )
+
+/**
+ * @brief Worker function of the "spawn" benchmark, does no work.
+ */
+
+static void* bench_spawn_worker( void* const p )
+{
+	return( p );
+}
+
+/**
+ * @brief The cost of starting threads per call of the multi-threaded
+ * functions (kh_run_threads()), for 2-16 threads, with threads created on
+ * each call, and with threads of a komihash_pool_t pool, versus the time a
+ * single thread takes to hash KOMIHASH_MT_MINLEN bytes via komihash_bulk(),
+ * which is the minimal work per thread. The resulting percentage is the
+ * worst-case overhead of starting threads.
+ */
+
+static void bench_spawn()
+{
+	const size_t l = KOMIHASH_MT_MINLEN;
+	uint8_t* const p = (uint8_t*) malloc( l );
+	komihash_pool_t pool;
+	double t1, t2;
+	int tc, r;
+
+	if( p == 0 )
+	{
+		printf( "spawn: cannot allocate\n\n" );
+		return;
+	}
+
+	bench_fill( p, l );
+
+	BENCH_MIN( t1,
+		for( r = 0; r < 10; r++ )
+		{
+			bench_sink += komihash_bulk( p, l, r );
+		}
+	)
+
+	t1 /= 10;
+
+	printf( "spawn: komihash_bulk() of KOMIHASH_MT_MINLEN (%i KB) bytes "
+		"%.0f us\n", (int) ( l >> 10 ), t1 * 1e6 );
+
+	for( tc = 2; tc <= 16; tc *= 2 )
+	{
+		BENCH_MIN( t2,
+			for( r = 0; r < 100; r++ )
+			{
+				kh_run_threads( bench_spawn_worker, 0, tc,
+					(size_t) tc * KOMIHASH_MT_MINLEN, 0 );
+			}
+		)
+
+		t2 /= 100;
+
+		printf( "spawn(%i threads): %.1f us per call, %.2f%% overhead\n",
+			tc, t2 * 1e6, t2 * 100 / ( t1 + t2 ));
+
+		komihash_pool_init( &pool, tc );
+
+		BENCH_MIN( t2,
+			for( r = 0; r < 100; r++ )
+			{
+				kh_run_threads( bench_spawn_worker, 0, tc,
+					(size_t) tc * KOMIHASH_MT_MINLEN, &pool );
+			}
+		)
+
+		komihash_pool_destroy( &pool );
+
+		t2 /= 100;
+
+		printf( "pool(%i threads): %.1f us per call, %.2f%% overhead\n",
+			tc, t2 * 1e6, t2 * 100 / ( t1 + t2 ));
+	}
+
+	free( p );
+
+	printf( "\n" );
+}
+
+/**
+ * @brief Scaling of the multi-threaded tree hashing (komihash_tree_mt()),
+ * versus single-threaded komihash_tree(), with a 256 MB message, and thread
+ * counts from 1 up to the number of online processors.
+ */
+
+static void bench_tree()
+{
+	const size_t l = 268435456;
+	uint8_t* const p = (uint8_t*) malloc( l );
+	uint64_t* const lh = (uint64_t*) malloc( KOMIHASH_TREE_LEAFCOUNT( l ) *
+		sizeof( uint64_t ));
+
+	const int pc = (int) sysconf( _SC_NPROCESSORS_ONLN );
+	double t1, t2;
+	size_t i;
+	int tc;
+
+	if( p == 0 || lh == 0 )
+	{
+		printf( "tree: cannot allocate\n\n" );
+		free( p );
+		free( lh );
+		return;
+	}
+
+	for( i = 0; i < l; i++ )
+	{
+		p[ i ] = (uint8_t) ( i * 31 + ( i >> 20 ));
+	}
+
+	BENCH_MIN( t1,
+		bench_sink += komihash_tree( p, l, 0 );
+	)
+
+	printf( "tree(256 MB): komihash_tree() %.1f GB/s, %i processor(s)\n",
+		l / t1 * 1e-9, pc );
+
+	for( tc = 1; tc <= pc; tc = ( tc < pc && tc * 2 > pc ? pc : tc * 2 ))
+	{
+		BENCH_MIN( t2,
+			bench_sink += komihash_tree_mt( p, l, 0, lh, tc );
+		)
+
+		printf( "tree(256 MB): komihash_tree_mt(), %i thread(s) %.1f GB/s, "
+			"x%.2f\n", tc, l / t2 * 1e-9, t1 / t2 );
+	}
+
+	free( p );
+	free( lh );
+
+	printf( "\n" );
+}
+
+/**
+ * @brief Scaling of the multi-threaded hashing of many messages
+ * (komihash_parallel_many(), and komihash_parallel_many_pool() with a pool
+ * of the same thread count), versus a komihash() loop, with 100000 messages
+ * of random lengths (mostly short, with a few large ones; about 220 MB in
+ * total), and thread counts from 1 up to the number of online processors.
+ */
+
+static void bench_many()
+{
+	const size_t l = 268435456;
+	const size_t n = 100000;
+	uint8_t* const p = (uint8_t*) malloc( l );
+	const void** const m = (const void**) malloc( n * sizeof( void* ));
+	size_t* const ml = (size_t*) malloc( n * sizeof( size_t ));
+	size_t* const o = (size_t*) malloc( n * sizeof( size_t ));
+	uint64_t* const h = (uint64_t*) malloc( n * sizeof( uint64_t ));
+
+	const int pc = (int) sysconf( _SC_NPROCESSORS_ONLN );
+	komihash_pool_t pool;
+	uint64_t Seed1 = 5;
+	uint64_t Seed2 = 6;
+	size_t i, s = 0;
+	double t1, t2;
+	int tc;
+
+	if( p == 0 || m == 0 || ml == 0 || o == 0 || h == 0 )
+	{
+		printf( "many: cannot allocate\n\n" );
+		free( p );
+		free( m );
+		free( ml );
+		free( o );
+		free( h );
+		return;
+	}
+
+	bench_fill( p, 1048576 );
+
+	for( i = 1048576; i < l; i += 1048576 )
+	{
+		memcpy( p + i, p, 1048576 );
+	}
+
+	// 1% of messages are up to 256 KB long, others are up to 2 KB long.
+
+	for( i = 0; i < n; i++ )
+	{
+		const uint64_t r = komirand( &Seed1, &Seed2 );
+		ml[ i ] = (size_t) ( r % 100 == 0 ? ( r >> 8 ) % 262144 :
+			( r >> 8 ) % 2048 );
+
+		if( s + ml[ i ] > l )
+		{
+			ml[ i ] = 0;
+		}
+
+		m[ i ] = p + s;
+		s += ml[ i ];
+	}
+
+	BENCH_MIN( t1,
+		for( i = 0; i < n; i++ )
+		{
+			h[ i ] = komihash( m[ i ], ml[ i ], 0 );
+		}
+
+		bench_sink += h[ 0 ];
+	)
+
+	printf( "many(%.0f MB): komihash() %.1f GB/s, %i processor(s)\n",
+		s / 1048576.0, s / t1 * 1e-9, pc );
+
+	for( tc = 1; tc <= pc; tc = ( tc < pc && tc * 2 > pc ? pc : tc * 2 ))
+	{
+		BENCH_MIN( t2,
+			komihash_parallel_many( m, ml, n, 0, h, o, tc );
+			bench_sink += h[ 0 ];
+		)
+
+		printf( "many(%.0f MB): komihash_parallel_many(), %i thread(s) "
+			"%.1f GB/s, x%.2f\n", s / 1048576.0, tc, s / t2 * 1e-9, t1 / t2 );
+
+		komihash_pool_init( &pool, tc );
+
+		BENCH_MIN( t2,
+			komihash_parallel_many_pool( m, ml, n, 0, h, o, &pool );
+			bench_sink += h[ 0 ];
+		)
+
+		komihash_pool_destroy( &pool );
+
+		printf( "many(%.0f MB): komihash_parallel_many_pool(), %i thread(s) "
+			"%.1f GB/s, x%.2f\n", s / 1048576.0, tc, s / t2 * 1e-9, t1 / t2 );
+	}
+
+	free( p );
+	free( m );
+	free( ml );
+	free( o );
+	free( h );
+
+	printf( "\n" );
+}
+
+#endif // defined( KOMIHASH_PTHREADS )
+
+typedef struct {
+	const char* Name; ///< Benchmark's name, for the command line.
+	void ( *Func )(); ///< Benchmark's function.
+} bench_t;
+
+int main( int argc, char* argv[])
+{
+	const bench_t benches[] = {
+		{ "padded", bench_padded },
+		{ "batch", bench_batch },
+		{ "bulk", bench_bulk },
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+		{ "kernel", bench_kernel },
+#endif // defined( __x86_64__ ) && defined( __GNUC__ )
+		{ "multi", bench_multi },
+		{ "strided", bench_strided },
+		{ "h128", bench_h128 },
+		{ "wide", bench_wide },
+		{ "row", bench_row },
+		{ "prefix", bench_prefix },
+		{ "ci", bench_ci },
+		{ "fold", bench_fold },
+#if defined( KOMIHASH_PTHREADS )
+		{ "spawn", bench_spawn },
+		{ "tree", bench_tree },
+		{ "many", bench_many },
+#endif // defined( KOMIHASH_PTHREADS )
+	};
+
+	const int benchc = (int) ( sizeof( benches ) / sizeof( benches[ 0 ]));
+	int i;
+
+	for( i = 0; i < benchc; i++ )
+	{
+		if( argc < 2 || strcmp( argv[ 1 ], benches[ i ].Name ) == 0 )
+		{
+			benches[ i ].Func();
+		}
+	}
+
+	return( 0 );
+}
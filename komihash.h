@@ -1,7 +1,7 @@
 /**
  * @file komihash.h
  *
- * @version 5.10
+ * @version 5.11
  *
  * @brief The inclusion file for the "komihash" 64-bit hash function,
  * "komirand" 64-bit PRNG, and streamed "komihash".
@@ -42,7 +42,7 @@
 #include <stdint.h>
 #include <string.h>
 
-#define KOMIHASH_VER_STR "5.10" ///< KOMIHASH source code version string.
+#define KOMIHASH_VER_STR "5.11" ///< KOMIHASH source code version string.
 
 /**
  * @def KOMIHASH_LITTLE_ENDIAN
@@ -189,6 +189,43 @@
 
 #endif // Prefetch macro
 
+/**
+ * @def KOMIHASH_BULK_PFLOC
+ * @brief Temporal locality of the prefetches made by the komihash_bulk()
+ * function.
+ *
+ * 0 - non-temporal (minimizes eviction of other data from CPU cache, but
+ * reduces throughput: on x86-64, 64 MB messages were hashed at 4.6 GB/s,
+ * versus 10.4 GB/s with 1), 1 - low temporal locality (default), 3 - high
+ * temporal locality. Can be defined externally.
+ */
+
+#if !defined( KOMIHASH_BULK_PFLOC )
+
+	#define KOMIHASH_BULK_PFLOC 1
+
+#endif // !defined( KOMIHASH_BULK_PFLOC )
+
+/**
+ * @def KOMIHASH_PREFETCH_BULK( a )
+ * @brief Memory address prefetch macro, for large messages.
+ *
+ * Uses the temporal locality specified by the KOMIHASH_BULK_PFLOC macro.
+ *
+ * @param a Prefetch address.
+ */
+
+#if defined( KOMIHASH_GCC_BUILTINS ) && !defined( __COMPCERT__ )
+
+	#define KOMIHASH_PREFETCH_BULK( a ) \
+		__builtin_prefetch( a, 0, KOMIHASH_BULK_PFLOC )
+
+#else // Prefetch macro
+
+	#define KOMIHASH_PREFETCH_BULK( a )
+
+#endif // Prefetch macro
+
 /**
  * @def KOMIHASH_PREFETCH_1
  * @brief Compiler-dependent address prefetch macro, ordered position 1.
@@ -372,6 +409,42 @@ static KOMIHASH_INLINE uint64_t kh_lpu64ec_l4( const uint8_t* const Msg,
 	return( (uint64_t) 1 << ml8 | m >> ( 64 - ml8 ));
 }
 
+/**
+ * @brief ASCII lowercase conversion of a 64-bit value's bytes (for internal
+ * use).
+ *
+ * Converts each `A-Z` byte of the value to `a-z`, via SWAR arithmetics,
+ * without branches. Other byte values, including non-ASCII ones, are left
+ * unchanged. Since the conversion is per-byte, it is independent of
+ * endianness, and the "final byte" padding of the `kh_lpu64ec_*()` values
+ * (0x01) is left unchanged as well.
+ *
+ * @param v Value to convert.
+ * @return Converted value.
+ */
+
+static KOMIHASH_INLINE uint64_t kh_lc64( const uint64_t v )
+{
+	const uint64_t h = v & 0x7F7F7F7F7F7F7F7F;
+	const uint64_t ge = h + 0x3F3F3F3F3F3F3F3F; // Bit 7 set if `>= 'A'`.
+	const uint64_t gt = h + 0x2525252525252525; // Bit 7 set if `> 'Z'`.
+
+	return( v | (( ge & ~gt & ~v & 0x8080808080808080 ) >> 2 ));
+}
+
+/**
+ * @brief Load unsigned 64-bit value with endianness-correction and ASCII
+ * lowercase conversion (for internal use).
+ *
+ * @param p Pointer to 8 bytes in memory. Alignment is unimportant.
+ * @return Endianness-corrected, lowercase-converted 64-bit value.
+ */
+
+static KOMIHASH_INLINE uint64_t kh_lu64ec_ci( const uint8_t* const p )
+{
+	return( kh_lc64( kh_lu64ec( p )));
+}
+
 /**
  * @fn void kh_m128( uint64_t u, uint64_t v, uint64_t* rl, uint64_t* rha )
  * @brief 64-bit by 64-bit unsigned multiplication with result accumulation.
@@ -471,6 +544,57 @@ static KOMIHASH_INLINE uint64_t kh_lpu64ec_l4( const uint8_t* const Msg,
 			(uint32_t) ( t >> 32 );
 	}
 
+	#if ( defined( __i386__ ) && defined( __SSE2__ )) || \
+		( defined( _M_IX86 ) && defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+
+		// 32-bit x86 with SSE2: the `PMULUDQ` instruction performs two 32-bit
+		// by 32-bit multiplications, and 64-bit additions are available. This
+		// is used by the 64-byte hashing loop, which keeps the hashing state
+		// in SSE2 registers. The scalar kh_m128() function above is faster for
+		// isolated multiplications, as it avoids transfers between SSE2 and
+		// general-purpose registers.
+
+		#include <emmintrin.h>
+
+		#define KOMIHASH_SSE2_M128
+
+		/**
+		 * @brief 64-bit by 64-bit unsigned multiplication with result
+		 * accumulation, for both 64-bit lanes of SSE2 registers.
+		 *
+		 * Equivalent to two kh_m128() calls, uses the same partial product
+		 * arrangement.
+		 *
+		 * @param u Multipliers 1.
+		 * @param v Multipliers 2.
+		 * @param[out] rl The lower halves of the 128-bit results.
+		 * @param[in,out] rha The accumulators to receive the higher halves of
+		 * the 128-bit results.
+		 */
+
+		static KOMIHASH_INLINE void kh_m128_sse2( const __m128i u,
+			const __m128i v, __m128i* const rl, __m128i* const rha )
+		{
+			const __m128i lm = _mm_set_epi32( 0, -1, 0, -1 );
+			const __m128i u1 = _mm_srli_epi64( u, 32 );
+			const __m128i v1 = _mm_srli_epi64( v, 32 );
+			const __m128i w0 = _mm_mul_epu32( u, v );
+			const __m128i t = _mm_add_epi64( _mm_mul_epu32( u1, v ),
+				_mm_srli_epi64( w0, 32 ));
+
+			const __m128i w1 = _mm_add_epi64( _mm_mul_epu32( u, v1 ),
+				_mm_and_si128( t, lm ));
+
+			*rha = _mm_add_epi64( *rha, _mm_add_epi64(
+				_mm_mul_epu32( u1, v1 ), _mm_add_epi64(
+				_mm_srli_epi64( w1, 32 ), _mm_srli_epi64( t, 32 ))));
+
+			*rl = _mm_or_si128( _mm_slli_epi64( w1, 32 ),
+				_mm_and_si128( w0, lm ));
+		}
+
+	#endif // SSE2
+
 #endif // defined( __IBMC__ )
 
 /**
@@ -498,16 +622,39 @@ static KOMIHASH_INLINE uint64_t kh_lpu64ec_l4( const uint8_t* const Msg,
 	kh_m128( Seed1, Seed5, &Seed1, &Seed5 ); \
 	Seed1 ^= Seed5;
 
+/**
+ * @def KOMIHASH_SEEDINIT()
+ * @brief Macro for the `Seed1` and `Seed5` initialization from the `UseSeed`
+ * value, including the initial hashing round.
+ *
+ * Declares the `Seed1` and `Seed5` variables, expects the `UseSeed` value.
+ */
+
+#define KOMIHASH_SEEDINIT() \
+	uint64_t Seed1 = 0x243F6A8885A308D3 ^ ( UseSeed & 0x5555555555555555 ); \
+	uint64_t Seed5 = 0x452821E638D01377 ^ ( UseSeed & 0xAAAAAAAAAAAAAAAA ); \
+	KOMIHASH_HASHROUND();
+
+/**
+ * @def KOMIHASH_HASH16_L( m, ld )
+ * @brief Macro for a common hashing round with 16-byte input, with a
+ * specified 64-bit value loader.
+ * @param m Message pointer, alignment is unimportant.
+ * @param ld Loader function, e.g., kh_lu64ec.
+ */
+
+#define KOMIHASH_HASH16_L( m, ld ) \
+	kh_m128( Seed1 ^ ld( m ), \
+		Seed5 ^ ld( m + 8 ), &Seed1, &Seed5 ); \
+	Seed1 ^= Seed5;
+
 /**
  * @def KOMIHASH_HASH16( m )
  * @brief Macro for a common hashing round with 16-byte input.
  * @param m Message pointer, alignment is unimportant.
  */
 
-#define KOMIHASH_HASH16( m ) \
-	kh_m128( Seed1 ^ kh_lu64ec( m ), \
-		Seed5 ^ kh_lu64ec( m + 8 ), &Seed1, &Seed5 ); \
-	Seed1 ^= Seed5;
+#define KOMIHASH_HASH16( m ) KOMIHASH_HASH16_L( m, kh_lu64ec )
 
 /**
  * @def KOMIHASH_HASHFIN()
@@ -524,67 +671,237 @@ static KOMIHASH_INLINE uint64_t kh_lpu64ec_l4( const uint8_t* const Msg,
 	return( Seed1 );
 
 /**
- * @def KOMIHASH_HASHLOOP64()
- * @brief Macro for a common 64-byte full-performance hashing loop.
+ * @def KOMIHASH_HASHFIN2()
+ * @brief Macro for hashing finalization round, with an optional upper half
+ * of the 128-bit hash value.
  *
- * Expects `Msg` and `MsgLen` values (greater than 63), requires initialized
- * `Seed1-8` values.
+ * Equivalent to the KOMIHASH_HASHFIN() macro, but if the `Hash2` pointer is
+ * non-zero, performs an extra hashing round, and stores its result to
+ * `*Hash2`. The returned value is unaffected.
+ */
+
+#define KOMIHASH_HASHFIN2() \
+	kh_m128( r1h, r2h, &Seed1, &Seed5 ); \
+	Seed1 ^= Seed5; \
+	KOMIHASH_HASHROUND(); \
+	if( Hash2 != 0 ) \
+	{ \
+		const uint64_t h1 = Seed1; \
+		KOMIHASH_HASHROUND(); \
+		*Hash2 = Seed1; \
+		return( h1 ); \
+	} \
+	return( Seed1 );
+
+/**
+ * @def KOMIHASH_HASH64( m, S1, S2, S3, S4, S5, S6, S7, S8 )
+ * @brief Macro for a common hashing round with 64-byte input.
  *
- * The "shifting" arrangement of `Seed1-4` XORs (below) does not increase
- * individual `SeedN` PRNG period beyond 2^64, but reduces a chance of any
+ * The "shifting" arrangement of `S1-4` XORs (below) does not increase
+ * individual `SN` PRNG period beyond 2^64, but reduces a chance of any
  * occassional synchronization between PRNG lanes happening. Practically,
- * `Seed1-4` together become a single "fused" 256-bit PRNG value, having 2^66
+ * `S1-4` together become a single "fused" 256-bit PRNG value, having 2^66
  * summary PRNG period.
+ *
+ * @param m Message pointer, alignment is unimportant.
+ * @param S1 Seed1 state variable.
+ * @param S2 Seed2 state variable.
+ * @param S3 Seed3 state variable.
+ * @param S4 Seed4 state variable.
+ * @param S5 Seed5 state variable.
+ * @param S6 Seed6 state variable.
+ * @param S7 Seed7 state variable.
+ * @param S8 Seed8 state variable.
  */
 
-#define KOMIHASH_HASHLOOP64() \
+#define KOMIHASH_HASH64( m, S1, S2, S3, S4, S5, S6, S7, S8 ) \
+	KOMIHASH_HASH64_L( m, S1, S2, S3, S4, S5, S6, S7, S8, kh_lu64ec )
+
+/**
+ * @def KOMIHASH_HASH64_L( m, S1, S2, S3, S4, S5, S6, S7, S8, ld )
+ * @brief Macro for a common hashing round with 64-byte input, with a
+ * specified 64-bit value loader.
+ *
+ * Equivalent to the KOMIHASH_HASH64() macro, with an additional `ld`
+ * parameter: the loader function, e.g., kh_lu64ec.
+ */
+
+#define KOMIHASH_HASH64_L( m, S1, S2, S3, S4, S5, S6, S7, S8, ld ) \
+	kh_m128( S1 ^ ld( m ), S5 ^ ld( m + 32 ), &S1, &S5 ); \
+	kh_m128( S2 ^ ld( m + 8 ), S6 ^ ld( m + 40 ), &S2, &S6 ); \
+	kh_m128( S3 ^ ld( m + 16 ), S7 ^ ld( m + 48 ), &S3, &S7 ); \
+	kh_m128( S4 ^ ld( m + 24 ), S8 ^ ld( m + 56 ), &S4, &S8 ); \
+	S2 ^= S5; \
+	S3 ^= S6; \
+	S4 ^= S7; \
+	S1 ^= S8;
+
+/**
+ * @def KOMIHASH_HASHLOOP64_L( ld )
+ * @brief Macro for a 64-byte hashing loop, with a specified 64-bit value
+ * loader.
+ *
+ * Expects `Msg` and `MsgLen` values (greater than 63), requires initialized
+ * `Seed1-8` values.
+ *
+ * @param ld Loader function, e.g., kh_lu64ec.
+ */
+
+#define KOMIHASH_HASHLOOP64_L( ld ) \
 	do \
 	{ \
 		KOMIHASH_PREFETCH_1( Msg ); \
 	\
-		kh_m128( Seed1 ^ kh_lu64ec( Msg ), \
-			Seed5 ^ kh_lu64ec( Msg + 32 ), &Seed1, &Seed5 ); \
-	\
-		kh_m128( Seed2 ^ kh_lu64ec( Msg + 8 ), \
-			Seed6 ^ kh_lu64ec( Msg + 40 ), &Seed2, &Seed6 ); \
-	\
-		kh_m128( Seed3 ^ kh_lu64ec( Msg + 16 ), \
-			Seed7 ^ kh_lu64ec( Msg + 48 ), &Seed3, &Seed7 ); \
-	\
-		kh_m128( Seed4 ^ kh_lu64ec( Msg + 24 ), \
-			Seed8 ^ kh_lu64ec( Msg + 56 ), &Seed4, &Seed8 ); \
+		KOMIHASH_HASH64_L( Msg, Seed1, Seed2, Seed3, Seed4, \
+			Seed5, Seed6, Seed7, Seed8, ld ); \
 	\
 		Msg += 64; \
 		MsgLen -= 64; \
 	\
 		KOMIHASH_PREFETCH_2( Msg ); \
-	\
-		Seed2 ^= Seed5; \
-		Seed3 ^= Seed6; \
-		Seed4 ^= Seed7; \
-		Seed1 ^= Seed8; \
 	\
 	} while( KOMIHASH_LIKELY( MsgLen > 63 ));
 
 /**
- * @brief The hashing epilogue function (for internal use).
+ * @def KOMIHASH_HASHLOOP64()
+ * @brief Macro for a common 64-byte full-performance hashing loop.
+ *
+ * Expects `Msg` and `MsgLen` values (greater than 63), requires initialized
+ * `Seed1-8` values.
+ */
+
+#if defined( KOMIHASH_SSE2_M128 )
+
+/**
+ * @brief The 64-byte hashing loop, for 32-bit x86 with SSE2 (for internal
+ * use).
+ *
+ * Keeps `Seed1-8` in SSE2 registers, in pairs, and performs two `kh_m128()`
+ * multiplications per kh_m128_sse2() call. Produces results equal to those
+ * of the generic KOMIHASH_HASHLOOP64() loop. The message is loaded directly
+ * into SSE2 registers, which is correct since x86 is little-endian.
+ *
+ * @param[in,out] pMsg Pointer to message pointer.
+ * @param[in,out] pMsgLen Pointer to message's remaining length, greater
+ * than 63.
+ * @param[in,out] Seed1 Pointer to `Seed1` (likewise for other seeds).
+ */
+
+static KOMIHASH_INLINE void kh_hashloop64_sse2( const uint8_t** const pMsg,
+	size_t* const pMsgLen, uint64_t* const Seed1, uint64_t* const Seed2,
+	uint64_t* const Seed3, uint64_t* const Seed4, uint64_t* const Seed5,
+	uint64_t* const Seed6, uint64_t* const Seed7, uint64_t* const Seed8 )
+{
+	const uint8_t* Msg = *pMsg;
+	size_t MsgLen = *pMsgLen;
+
+	__m128i S12 = _mm_unpacklo_epi64( _mm_loadl_epi64( (__m128i*) Seed1 ),
+		_mm_loadl_epi64( (__m128i*) Seed2 ));
+
+	__m128i S34 = _mm_unpacklo_epi64( _mm_loadl_epi64( (__m128i*) Seed3 ),
+		_mm_loadl_epi64( (__m128i*) Seed4 ));
+
+	__m128i S56 = _mm_unpacklo_epi64( _mm_loadl_epi64( (__m128i*) Seed5 ),
+		_mm_loadl_epi64( (__m128i*) Seed6 ));
+
+	__m128i S78 = _mm_unpacklo_epi64( _mm_loadl_epi64( (__m128i*) Seed7 ),
+		_mm_loadl_epi64( (__m128i*) Seed8 ));
+
+	do
+	{
+		KOMIHASH_PREFETCH_1( Msg );
+
+		kh_m128_sse2( _mm_xor_si128( S12,
+			_mm_loadu_si128( (const __m128i*) Msg )),
+			_mm_xor_si128( S56, _mm_loadu_si128( (const __m128i*) ( Msg + 32 ))),
+			&S12, &S56 );
+
+		kh_m128_sse2( _mm_xor_si128( S34,
+			_mm_loadu_si128( (const __m128i*) ( Msg + 16 ))),
+			_mm_xor_si128( S78, _mm_loadu_si128( (const __m128i*) ( Msg + 48 ))),
+			&S34, &S78 );
+
+		// Seed1 ^= Seed8, Seed2 ^= Seed5, Seed3 ^= Seed6, Seed4 ^= Seed7.
+
+		S12 = _mm_xor_si128( S12, _mm_castpd_si128( _mm_shuffle_pd(
+			_mm_castsi128_pd( S78 ), _mm_castsi128_pd( S56 ), 1 )));
+
+		S34 = _mm_xor_si128( S34, _mm_castpd_si128( _mm_shuffle_pd(
+			_mm_castsi128_pd( S56 ), _mm_castsi128_pd( S78 ), 1 )));
+
+		Msg += 64;
+		MsgLen -= 64;
+
+		KOMIHASH_PREFETCH_2( Msg );
+
+	} while( KOMIHASH_LIKELY( MsgLen > 63 ));
+
+	_mm_storel_epi64( (__m128i*) Seed1, S12 );
+	_mm_storel_epi64( (__m128i*) Seed2, _mm_unpackhi_epi64( S12, S12 ));
+	_mm_storel_epi64( (__m128i*) Seed3, S34 );
+	_mm_storel_epi64( (__m128i*) Seed4, _mm_unpackhi_epi64( S34, S34 ));
+	_mm_storel_epi64( (__m128i*) Seed5, S56 );
+	_mm_storel_epi64( (__m128i*) Seed6, _mm_unpackhi_epi64( S56, S56 ));
+	_mm_storel_epi64( (__m128i*) Seed7, S78 );
+	_mm_storel_epi64( (__m128i*) Seed8, _mm_unpackhi_epi64( S78, S78 ));
+
+	*pMsg = Msg;
+	*pMsgLen = MsgLen;
+}
+
+#define KOMIHASH_HASHLOOP64() \
+	kh_hashloop64_sse2( &Msg, &MsgLen, &Seed1, &Seed2, &Seed3, &Seed4, \
+		&Seed5, &Seed6, &Seed7, &Seed8 );
+
+#else // defined( KOMIHASH_SSE2_M128 )
+
+#define KOMIHASH_HASHLOOP64() KOMIHASH_HASHLOOP64_L( kh_lu64ec )
+
+#endif // defined( KOMIHASH_SSE2_M128 )
+
+/**
+ * @def KOMIHASH_LDCI( v )
+ * @brief Macro converts a loaded 64-bit value to ASCII lowercase, if the
+ * `Ci` variable is non-zero (for internal use).
+ * @param v Loaded value.
+ */
+
+#define KOMIHASH_LDCI( v ) ( Ci ? kh_lc64( v ) : ( v ))
+
+/**
+ * @def KOMIHASH_LU64CI( p )
+ * @brief Macro loads a 64-bit value with endianness-correction, and converts
+ * it to ASCII lowercase, if the `Ci` variable is non-zero (for internal
+ * use).
+ * @param p Pointer to 8 bytes in memory. Alignment is unimportant.
+ */
+
+#define KOMIHASH_LU64CI( p ) KOMIHASH_LDCI( kh_lu64ec( p ))
+
+/**
+ * @brief The hashing epilogue function, with an optional upper half of the
+ * 128-bit hash value, optionally ASCII case-insensitive (for internal use).
  *
  * @param Msg Pointer to the remaining part of the message.
  * @param MsgLen Remaining part's length, can be 0.
  * @param Seed1 Latest Seed1 value.
  * @param Seed5 Latest Seed5 value.
- * @return 64-bit hash value.
+ * @param[out] Hash2 Pointer to the upper half of the 128-bit hash value, or
+ * 0 if not needed.
+ * @param Ci 1 if `A-Z` bytes should be converted to `a-z`, 0 otherwise.
+ * Expected to be a constant, for branches to be eliminated.
+ * @return 64-bit hash value (the lower half of the 128-bit hash value).
  */
 
-static KOMIHASH_INLINE uint64_t komihash_epi( const uint8_t* Msg,
-	size_t MsgLen, uint64_t Seed1, uint64_t Seed5 )
+static KOMIHASH_INLINE uint64_t kh_epi( const uint8_t* Msg, size_t MsgLen,
+	uint64_t Seed1, uint64_t Seed5, uint64_t* const Hash2, const int Ci )
 {
 	uint64_t r1h, r2h;
 
 	if( KOMIHASH_LIKELY( MsgLen > 31 ))
 	{
-		KOMIHASH_HASH16( Msg );
-		KOMIHASH_HASH16( Msg + 16 );
+		KOMIHASH_HASH16_L( Msg, KOMIHASH_LU64CI );
+		KOMIHASH_HASH16_L( Msg + 16, KOMIHASH_LU64CI );
 
 		Msg += 32;
 		MsgLen -= 32;
@@ -592,7 +909,7 @@ static KOMIHASH_INLINE uint64_t komihash_epi( const uint8_t* Msg,
 
 	if( MsgLen > 15 )
 	{
-		KOMIHASH_HASH16( Msg );
+		KOMIHASH_HASH16_L( Msg, KOMIHASH_LU64CI );
 
 		Msg += 16;
 		MsgLen -= 16;
@@ -600,53 +917,77 @@ static KOMIHASH_INLINE uint64_t komihash_epi( const uint8_t* Msg,
 
 	if( MsgLen > 7 )
 	{
-		r2h = Seed5 ^ kh_lpu64ec_l4( Msg + 8, MsgLen - 8 );
-		r1h = Seed1 ^ kh_lu64ec( Msg );
+		r2h = Seed5 ^ KOMIHASH_LDCI( kh_lpu64ec_l4( Msg + 8, MsgLen - 8 ));
+		r1h = Seed1 ^ KOMIHASH_LU64CI( Msg );
 	}
 	else
 	{
-		r1h = Seed1 ^ kh_lpu64ec_l4( Msg, MsgLen );
+		r1h = Seed1 ^ KOMIHASH_LDCI( kh_lpu64ec_l4( Msg, MsgLen ));
 		r2h = Seed5;
 	}
 
-	KOMIHASH_HASHFIN();
+	KOMIHASH_HASHFIN2();
 }
 
 /**
- * @brief KOMIHASH 64-bit hash function.
- *
- * Produces and returns a 64-bit hash value of the specified message, string,
- * or binary data block. Designed for 64-bit hash-table and hash-map uses.
- * Produces identical hashes on both big- and little-endian systems.
+ * @brief The hashing epilogue function, with an optional upper half of the
+ * 128-bit hash value (for internal use).
  *
- * @param Msg0 The message to produce a hash from. The alignment of this
- * pointer is unimportant. It is valid to pass 0 when `MsgLen` equals 0
- * (assuming that compiler's implementation of the address prefetch permits
- * the use of zero address).
- * @param MsgLen Message's length, in bytes, can be zero.
- * @param UseSeed Optional value, to use instead of the default seed. To use
- * the default seed, set to 0. The UseSeed value can have any bit length and
- * statistical quality, and is used only as an additional entropy source. May
- * need endianness-correction via KOMIHASH_EC64(), if this value is shared
- * between big- and little-endian systems.
- * @return 64-bit hash of the input data. Should be endianness-corrected when
- * this value is shared between big- and little-endian systems.
+ * @param Msg Pointer to the remaining part of the message.
+ * @param MsgLen Remaining part's length, can be 0.
+ * @param Seed1 Latest Seed1 value.
+ * @param Seed5 Latest Seed5 value.
+ * @param[out] Hash2 Pointer to the upper half of the 128-bit hash value, or
+ * 0 if not needed.
+ * @return 64-bit hash value (the lower half of the 128-bit hash value).
  */
 
-static inline uint64_t komihash( const void* const Msg0, size_t MsgLen,
-	const uint64_t UseSeed )
+static KOMIHASH_INLINE uint64_t komihash_epi2( const uint8_t* const Msg,
+	const size_t MsgLen, const uint64_t Seed1, const uint64_t Seed5,
+	uint64_t* const Hash2 )
 {
-	const uint8_t* Msg = (const uint8_t*) Msg0;
+	return( kh_epi( Msg, MsgLen, Seed1, Seed5, Hash2, 0 ));
+}
 
-	// The seeds are initialized to the first mantissa bits of PI.
+/**
+ * @brief The hashing epilogue function (for internal use).
+ *
+ * @param Msg Pointer to the remaining part of the message.
+ * @param MsgLen Remaining part's length, can be 0.
+ * @param Seed1 Latest Seed1 value.
+ * @param Seed5 Latest Seed5 value.
+ * @return 64-bit hash value.
+ */
 
-	uint64_t Seed1 = 0x243F6A8885A308D3 ^ ( UseSeed & 0x5555555555555555 );
-	uint64_t Seed5 = 0x452821E638D01377 ^ ( UseSeed & 0xAAAAAAAAAAAAAAAA );
-	uint64_t r1h, r2h;
+static KOMIHASH_INLINE uint64_t komihash_epi( const uint8_t* const Msg,
+	const size_t MsgLen, const uint64_t Seed1, const uint64_t Seed5 )
+{
+	return( komihash_epi2( Msg, MsgLen, Seed1, Seed5, 0 ));
+}
 
-	KOMIHASH_PREFETCH( Msg );
+/**
+ * @brief The hashing function's body, with an optional upper half of the
+ * 128-bit hash value, optionally ASCII case-insensitive (for internal use).
+ *
+ * Hashes the message, starting from the state produced by the initial
+ * hashing round. Optionally produces the upper half of the 128-bit hash
+ * value.
+ *
+ * @param Msg Message pointer, alignment is unimportant.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param Seed1 Initial Seed1 value.
+ * @param Seed5 Initial Seed5 value.
+ * @param[out] Hash2 Pointer to the upper half of the 128-bit hash value, or
+ * 0 if not needed.
+ * @param Ci 1 if `A-Z` bytes should be converted to `a-z`, 0 otherwise.
+ * Expected to be a constant, for branches to be eliminated.
+ * @return 64-bit hash value (the lower half of the 128-bit hash value).
+ */
 
-	KOMIHASH_HASHROUND(); // Required for Perlin Noise.
+static KOMIHASH_INLINE uint64_t kh_body( const uint8_t* Msg, size_t MsgLen,
+	uint64_t Seed1, uint64_t Seed5, uint64_t* const Hash2, const int Ci )
+{
+	uint64_t r1h, r2h;
 
 	if( KOMIHASH_LIKELY( MsgLen < 16 ))
 	{
@@ -660,33 +1001,37 @@ static inline uint64_t komihash( const void* const Msg0, size_t MsgLen,
 			// addition). Message's statistics and distribution are thus
 			// unimportant.
 
-			r2h ^= kh_lpu64ec_l3( Msg + 8, MsgLen - 8 );
-			r1h ^= kh_lu64ec( Msg );
+			r2h ^= KOMIHASH_LDCI( kh_lpu64ec_l3( Msg + 8, MsgLen - 8 ));
+			r1h ^= KOMIHASH_LU64CI( Msg );
 		}
 		else
 		if( KOMIHASH_LIKELY( MsgLen != 0 ))
 		{
-			r1h ^= kh_lpu64ec_nz( Msg, MsgLen );
+			r1h ^= KOMIHASH_LDCI( kh_lpu64ec_nz( Msg, MsgLen ));
 		}
 
-		KOMIHASH_HASHFIN();
+		KOMIHASH_HASHFIN2();
 	}
 
 	if( KOMIHASH_LIKELY( MsgLen < 32 ))
 	{
-		KOMIHASH_HASH16( Msg );
+		KOMIHASH_HASH16_L( Msg, KOMIHASH_LU64CI );
 
 		if( MsgLen > 23 )
 		{
-			r2h = Seed5 ^ kh_lpu64ec_l4( Msg + 24, MsgLen - 24 );
-			r1h = Seed1 ^ kh_lu64ec( Msg + 16 );
-			KOMIHASH_HASHFIN();
+			r2h = Seed5 ^ KOMIHASH_LDCI( kh_lpu64ec_l4( Msg + 24,
+				MsgLen - 24 ));
+
+			r1h = Seed1 ^ KOMIHASH_LU64CI( Msg + 16 );
+			KOMIHASH_HASHFIN2();
 		}
 		else
 		{
-			r1h = Seed1 ^ kh_lpu64ec_l4( Msg + 16, MsgLen - 16 );
+			r1h = Seed1 ^ KOMIHASH_LDCI( kh_lpu64ec_l4( Msg + 16,
+				MsgLen - 16 ));
+
 			r2h = Seed5;
-			KOMIHASH_HASHFIN();
+			KOMIHASH_HASHFIN2();
 		}
 	}
 
@@ -699,250 +1044,297 @@ static inline uint64_t komihash( const void* const Msg0, size_t MsgLen,
 		uint64_t Seed7 = 0xC0AC29B7C97C50DD ^ Seed5;
 		uint64_t Seed8 = 0x3F84D5B5B5470917 ^ Seed5;
 
-		KOMIHASH_HASHLOOP64();
+		if( Ci )
+		{
+			KOMIHASH_HASHLOOP64_L( kh_lu64ec_ci );
+		}
+		else
+		{
+			KOMIHASH_HASHLOOP64();
+		}
 
 		Seed5 ^= Seed6 ^ Seed7 ^ Seed8;
 		Seed1 ^= Seed2 ^ Seed3 ^ Seed4;
 	}
 
-	return( komihash_epi( Msg, MsgLen, Seed1, Seed5 ));
+	return( kh_epi( Msg, MsgLen, Seed1, Seed5, Hash2, Ci ));
 }
 
 /**
- * @brief KOMIRAND 64-bit pseudo-random number generator.
- *
- * Simple, reliable, self-starting yet efficient PRNG, with 2^64 period.
- * 0.62 cycles/byte performance. Self-starts in 4 iterations, which is a
- * suggested "warming up" initialization before using its output.
+ * @brief The hashing function's body, with an optional upper half of the
+ * 128-bit hash value (for internal use).
  *
- * @param[in,out] Seed1 Seed value 1. Can be initialized to any value
- * (even 0). This is the usual "PRNG seed" value.
- * @param[in,out] Seed2 Seed value 2, a supporting variable. Best initialized
- * to the same value as `Seed1`.
- * @return The next uniformly-random 64-bit value.
+ * @param Msg Message pointer, alignment is unimportant.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param Seed1 Initial Seed1 value.
+ * @param Seed5 Initial Seed5 value.
+ * @param[out] Hash2 Pointer to the upper half of the 128-bit hash value, or
+ * 0 if not needed.
+ * @return 64-bit hash value (the lower half of the 128-bit hash value).
  */
 
-static KOMIHASH_INLINE uint64_t komirand( uint64_t* const Seed1,
-	uint64_t* const Seed2 )
+static KOMIHASH_INLINE uint64_t komihash_body2( const uint8_t* const Msg,
+	const size_t MsgLen, const uint64_t Seed1, const uint64_t Seed5,
+	uint64_t* const Hash2 )
 {
-	uint64_t s1 = *Seed1;
-	uint64_t s2 = *Seed2;
-
-	kh_m128( s1, s2, &s1, &s2 );
-	s2 += 0xAAAAAAAAAAAAAAAA;
-	s1 ^= s2;
-
-	*Seed2 = s2;
-	*Seed1 = s1;
-
-	return( s1 );
+	return( kh_body( Msg, MsgLen, Seed1, Seed5, Hash2, 0 ));
 }
 
 /**
- * @def KOMIHASH_BUFSIZE
- * @brief Streamed hashing's buffer size, in bytes.
+ * @brief The hashing function's body (for internal use).
  *
- * Must be a multiple of 64, and not less than 128. Can be defined externally.
- */
-
-#if !defined( KOMIHASH_BUFSIZE )
-
-	#define KOMIHASH_BUFSIZE 768
-
-#endif // !defined( KOMIHASH_BUFSIZE )
-
-/**
- * @brief Context structure for the streamed "komihash" hashing.
+ * Hashes the message, starting from the state produced by the initial
+ * hashing round.
  *
- * The komihash_init() function should be called to initalize the structure
- * before hashing. Note that the default buffer size is modest, permitting
- * placement of this structure on stack. `Seed[ 0 ]` is used as `UseSeed`
- * value storage.
+ * @param Msg Message pointer, alignment is unimportant.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param Seed1 Initial Seed1 value.
+ * @param Seed5 Initial Seed5 value.
+ * @return 64-bit hash value.
  */
 
-typedef struct {
-	uint8_t pb[ 8 ]; ///< Buffer's padding bytes, to avoid OOB.
-	uint8_t Buf[ KOMIHASH_BUFSIZE ]; ///< Buffer.
-	uint64_t Seed[ 8 ]; ///< Hashing state variables.
-	size_t BufFill; ///< Buffer fill count (position), in bytes.
-	size_t IsHashing; ///< 0 or 1, equals 1 if the actual hashing was started.
-} komihash_stream_t;
+static KOMIHASH_INLINE uint64_t komihash_body( const uint8_t* const Msg,
+	const size_t MsgLen, const uint64_t Seed1, const uint64_t Seed5 )
+{
+	return( komihash_body2( Msg, MsgLen, Seed1, Seed5, 0 ));
+}
 
 /**
- * @brief Function initializes the streamed "komihash" hashing session.
+ * @brief KOMIHASH 64-bit hash function.
  *
- * @param[out] ctx Pointer to the context structure.
+ * Produces and returns a 64-bit hash value of the specified message, string,
+ * or binary data block. Designed for 64-bit hash-table and hash-map uses.
+ * Produces identical hashes on both big- and little-endian systems.
+ *
+ * @param Msg0 The message to produce a hash from. The alignment of this
+ * pointer is unimportant. It is valid to pass 0 when `MsgLen` equals 0
+ * (assuming that compiler's implementation of the address prefetch permits
+ * the use of zero address).
+ * @param MsgLen Message's length, in bytes, can be zero.
  * @param UseSeed Optional value, to use instead of the default seed. To use
  * the default seed, set to 0. The UseSeed value can have any bit length and
  * statistical quality, and is used only as an additional entropy source. May
  * need endianness-correction via KOMIHASH_EC64(), if this value is shared
  * between big- and little-endian systems.
+ * @return 64-bit hash of the input data. Should be endianness-corrected when
+ * this value is shared between big- and little-endian systems.
  */
 
-static inline void komihash_stream_init( komihash_stream_t* const ctx,
+static inline uint64_t komihash( const void* const Msg0, size_t MsgLen,
 	const uint64_t UseSeed )
 {
-	ctx -> Seed[ 0 ] = UseSeed;
-	ctx -> BufFill = 0;
-	ctx -> IsHashing = 0;
+	const uint8_t* Msg = (const uint8_t*) Msg0;
+
+	// The seeds are initialized to the first mantissa bits of PI.
+
+	uint64_t Seed1 = 0x243F6A8885A308D3 ^ ( UseSeed & 0x5555555555555555 );
+	uint64_t Seed5 = 0x452821E638D01377 ^ ( UseSeed & 0xAAAAAAAAAAAAAAAA );
+
+	KOMIHASH_PREFETCH( Msg );
+
+	KOMIHASH_HASHROUND(); // Required for Perlin Noise.
+
+	return( komihash_body( Msg, MsgLen, Seed1, Seed5 ));
 }
 
 /**
- * @brief Function updates the streamed hashing state with a new input data.
+ * @brief KOMIHASH 128-bit hash function.
  *
- * @param[in,out] ctx Pointer to the context structure. The structure must be
- * initialized via the komihash_stream_init() function.
- * @param Msg0 The next part of the whole message being hashed. The alignment
- * of this pointer is unimportant. It is valid to pass 0 when `MsgLen` equals
- * 0.
+ * Produces a 128-bit hash value of the specified message, for uses where
+ * 64-bit hash collisions are a concern (e.g., content addressing of a large
+ * number of objects). The lower half of the hash value is equal to the value
+ * returned by the komihash() function, for the same message and seed; the
+ * upper half is produced by an extra hashing round of the final 128-bit
+ * state. The cost of the 128-bit hash value is thus only slightly higher
+ * than that of the 64-bit one.
+ *
+ * @param Msg0 The message to produce a hash from. The alignment of this
+ * pointer is unimportant.
  * @param MsgLen Message's length, in bytes, can be zero.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ * @param[out] Hash Resulting 128-bit hash value: `Hash[ 0 ]` receives the
+ * lower half, `Hash[ 1 ]` receives the upper half. Should be
+ * endianness-corrected when shared between big- and little-endian systems.
  */
 
-static inline void komihash_stream_update( komihash_stream_t* const ctx,
-	const void* const Msg0, size_t MsgLen )
+static inline void komihash128( const void* const Msg0, size_t MsgLen,
+	const uint64_t UseSeed, uint64_t* const Hash )
 {
 	const uint8_t* Msg = (const uint8_t*) Msg0;
 
-	const uint8_t* SwMsg = 0;
-	size_t SwMsgLen = 0;
-	size_t BufFill = ctx -> BufFill;
+	KOMIHASH_SEEDINIT();
+	KOMIHASH_PREFETCH( Msg );
 
-	if( BufFill + MsgLen >= KOMIHASH_BUFSIZE && BufFill != 0 )
-	{
-		const size_t CopyLen = KOMIHASH_BUFSIZE - BufFill;
-		memcpy( ctx -> Buf + BufFill, Msg, CopyLen );
-		BufFill = 0;
+	Hash[ 0 ] = komihash_body2( Msg, MsgLen, Seed1, Seed5, Hash + 1 );
+}
 
-		SwMsg = Msg + CopyLen;
-		SwMsgLen = MsgLen - CopyLen;
+/**
+ * @brief Load two unsigned 64-bit values with padding, over-reading (for
+ * internal use).
+ *
+ * Function builds the final 128-bit hashing input out of remaining bytes in
+ * a message, without message length-dependent branching: two full 64-bit
+ * words are loaded, masked, and padded with the "final byte". The produced
+ * values are equal to those produced by the komihash() function's
+ * `kh_lpu64ec_*()` calls. Reads 16 bytes of memory at `Msg`, irrespective
+ * of the `MsgLen` value.
+ *
+ * @param Msg Message pointer, alignment is unimportant.
+ * @param MsgLen Message's remaining length, in bytes; less than 16, can be
+ * 0.
+ * @param zm Zero-length mask: 0 if no padding should be applied to a
+ * zero-length message, or ~0 otherwise.
+ * @param[out] r1 The first resulting value (XOR operand for `Seed1`).
+ * @param[out] r2 The second resulting value (XOR operand for `Seed5`).
+ */
 
-		Msg = ctx -> Buf;
-		MsgLen = KOMIHASH_BUFSIZE;
-	}
+static KOMIHASH_INLINE void kh_lpu128ec_ov( const uint8_t* const Msg,
+	const size_t MsgLen, const uint64_t zm, uint64_t* const r1,
+	uint64_t* const r2 )
+{
+	const uint64_t w0 = kh_lu64ec( Msg );
+	const uint64_t w1 = kh_lu64ec( Msg + 8 );
+	const uint64_t hm = (uint64_t) 0 - (uint64_t) ( MsgLen >> 3 );
+	const uint64_t nzm = zm | ( (uint64_t) 0 - (uint64_t) ( MsgLen != 0 ));
+	const uint64_t pad = (uint64_t) 1 << ( MsgLen * 8 & 63 );
+	const uint64_t tail = (( w0 ^ (( w0 ^ w1 ) & hm )) & ( pad - 1 )) | pad;
+
+	*r1 = ( w0 & hm ) | ( tail & ~hm & nzm );
+	*r2 = tail & hm;
+}
 
-	if( BufFill == 0 )
-	{
-		while( MsgLen > 127 )
-		{
-			uint64_t Seed1, Seed2, Seed3, Seed4;
-			uint64_t Seed5, Seed6, Seed7, Seed8;
+/**
+ * @brief KOMIHASH 64-bit hash function, padded-buffer variant.
+ *
+ * Returns a value equal to the value returned by the komihash() function,
+ * but handles 0-31-byte messages with only a 16-byte length-class branch
+ * (0-15 or 16-31 bytes), instead of per-byte-count branching, by loading
+ * full 64-bit words and masking them. This function
+ * can only be used if at least 16 bytes of memory are readable after the
+ * message's end (e.g., when keys are stored in an arena with a padding). The
+ * function is beneficial when message lengths are random, and branch
+ * mispredictions dominate.
+ *
+ * @param Msg0 The message to produce a hash from. The alignment of this
+ * pointer is unimportant.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ * @return 64-bit hash of the input data.
+ */
 
-			KOMIHASH_PREFETCH_2( Msg );
+static inline uint64_t komihash_padded( const void* const Msg0,
+	const size_t MsgLen, const uint64_t UseSeed )
+{
+	const uint8_t* const Msg = (const uint8_t*) Msg0;
+	uint64_t r1h, r2h;
 
-			if( ctx -> IsHashing )
-			{
-				Seed1 = ctx -> Seed[ 0 ];
-				Seed2 = ctx -> Seed[ 1 ];
-				Seed3 = ctx -> Seed[ 2 ];
-				Seed4 = ctx -> Seed[ 3 ];
-				Seed5 = ctx -> Seed[ 4 ];
-				Seed6 = ctx -> Seed[ 5 ];
-				Seed7 = ctx -> Seed[ 6 ];
-				Seed8 = ctx -> Seed[ 7 ];
-			}
-			else
-			{
-				ctx -> IsHashing = 1;
+	KOMIHASH_PREFETCH( Msg );
 
-				const uint64_t UseSeed = ctx -> Seed[ 0 ];
-				Seed1 = 0x243F6A8885A308D3 ^ ( UseSeed & 0x5555555555555555 );
-				Seed5 = 0x452821E638D01377 ^ ( UseSeed & 0xAAAAAAAAAAAAAAAA );
+	KOMIHASH_SEEDINIT();
 
-				KOMIHASH_HASHROUND();
+	if( KOMIHASH_LIKELY( MsgLen < 16 ))
+	{
+		kh_lpu128ec_ov( Msg, MsgLen, 0, &r1h, &r2h );
 
-				Seed2 = 0x13198A2E03707344 ^ Seed1;
-				Seed3 = 0xA4093822299F31D0 ^ Seed1;
-				Seed4 = 0x082EFA98EC4E6C89 ^ Seed1;
-				Seed6 = 0xBE5466CF34E90C6C ^ Seed5;
-				Seed7 = 0xC0AC29B7C97C50DD ^ Seed5;
-				Seed8 = 0x3F84D5B5B5470917 ^ Seed5;
-			}
+		r1h ^= Seed1;
+		r2h ^= Seed5;
 
-			KOMIHASH_HASHLOOP64();
+		KOMIHASH_HASHFIN();
+	}
 
-			ctx -> Seed[ 0 ] = Seed1;
-			ctx -> Seed[ 1 ] = Seed2;
-			ctx -> Seed[ 2 ] = Seed3;
-			ctx -> Seed[ 3 ] = Seed4;
-			ctx -> Seed[ 4 ] = Seed5;
-			ctx -> Seed[ 5 ] = Seed6;
-			ctx -> Seed[ 6 ] = Seed7;
-			ctx -> Seed[ 7 ] = Seed8;
+	if( KOMIHASH_LIKELY( MsgLen < 32 ))
+	{
+		KOMIHASH_HASH16( Msg );
 
-			if( SwMsgLen == 0 )
-			{
-				if( MsgLen != 0 )
-				{
-					break;
-				}
+		kh_lpu128ec_ov( Msg + 16, MsgLen - 16, ~(uint64_t) 0, &r1h, &r2h );
 
-				ctx -> BufFill = 0;
-				return;
-			}
+		r1h ^= Seed1;
+		r2h ^= Seed5;
 
-			Msg = SwMsg;
-			MsgLen = SwMsgLen;
-			SwMsgLen = 0;
-		}
+		KOMIHASH_HASHFIN();
 	}
 
-	ctx -> BufFill = BufFill + MsgLen;
-	uint8_t* op = ctx -> Buf + BufFill;
+	return( komihash_body( Msg, MsgLen, Seed1, Seed5 ));
+}
 
-	while( MsgLen != 0 )
-	{
-		*op = *Msg;
-		Msg++;
-		op++;
-		MsgLen--;
-	}
+/**
+ * @brief Precomputed seed state for the "komihash" hashing.
+ *
+ * Holds the hashing state produced from the `UseSeed` value by the initial
+ * hashing round, including the derived `Seed2-4` and `Seed6-8` values. Can
+ * be used for hashing with a long-lived (e.g., per hash-table) secret seed,
+ * to skip the seed initialization on each call. The komihash_key_init()
+ * function should be called to initialize the structure.
+ */
+
+typedef struct {
+	uint64_t Seed[ 8 ]; ///< Initial hashing state variables.
+} komihash_key_t;
+
+/**
+ * @brief Function initializes the precomputed seed state.
+ *
+ * @param[out] key Pointer to the seed state structure.
+ * @param UseSeed The seed value, the same as in the komihash() function.
+ */
+
+static inline void komihash_key_init( komihash_key_t* const key,
+	const uint64_t UseSeed )
+{
+	KOMIHASH_SEEDINIT();
+
+	key -> Seed[ 0 ] = Seed1;
+	key -> Seed[ 1 ] = 0x13198A2E03707344 ^ Seed1;
+	key -> Seed[ 2 ] = 0xA4093822299F31D0 ^ Seed1;
+	key -> Seed[ 3 ] = 0x082EFA98EC4E6C89 ^ Seed1;
+	key -> Seed[ 4 ] = Seed5;
+	key -> Seed[ 5 ] = 0xBE5466CF34E90C6C ^ Seed5;
+	key -> Seed[ 6 ] = 0xC0AC29B7C97C50DD ^ Seed5;
+	key -> Seed[ 7 ] = 0x3F84D5B5B5470917 ^ Seed5;
 }
 
 /**
- * @brief Function finalizes the streamed "komihash" hashing session.
- * 
- * Returns the resulting hash value of the previously hashed data. This value
- * is equal to the value returned by the komihash() function for the same
- * provided data.
+ * @brief KOMIHASH 64-bit hash function, with a precomputed seed state.
  *
- * Note that since this function is non-destructive to the context structure,
- * the function can be used to obtain intermediate hashes of the data stream
- * being hashed, and the hashing can then be resumed.
+ * Returns a value equal to the value returned by the komihash() function for
+ * the same message and the `UseSeed` value that was used to initialize the
+ * `key` structure.
  *
- * @param[in] ctx Pointer to the context structure. The structure must be
- * initialized via the komihash_stream_init() function.
- * @return 64-bit hash value. Should be endianness-corrected when this value
- * is shared between big- and little-endian systems.
+ * @param Msg0 The message to produce a hash from. The alignment of this
+ * pointer is unimportant. It is valid to pass 0 when `MsgLen` equals 0.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param key Pointer to the seed state structure, initialized via the
+ * komihash_key_init() function.
+ * @return 64-bit hash of the input data.
  */
 
-static inline uint64_t komihash_stream_final( komihash_stream_t* const ctx )
+static inline uint64_t komihash_with_key( const void* const Msg0,
+	size_t MsgLen, const komihash_key_t* const key )
 {
-	const uint8_t* Msg = ctx -> Buf;
-	size_t MsgLen = ctx -> BufFill;
+	const uint8_t* Msg = (const uint8_t*) Msg0;
 
-	if( ctx -> IsHashing == 0 )
+	KOMIHASH_PREFETCH( Msg );
+
+	if( KOMIHASH_LIKELY( MsgLen < 64 ))
 	{
-		return( komihash( Msg, MsgLen, ctx -> Seed[ 0 ]));
+		return( komihash_body( Msg, MsgLen, key -> Seed[ 0 ],
+			key -> Seed[ 4 ]));
 	}
 
-	ctx -> pb[ 4 ] = 0;
-	ctx -> pb[ 5 ] = 0;
-	ctx -> pb[ 6 ] = 0;
-	ctx -> pb[ 7 ] = 0;
+	// The 64-byte loop starts from the precomputed `Seed1-8` values.
 
-	uint64_t Seed1 = ctx -> Seed[ 0 ];
-	uint64_t Seed2 = ctx -> Seed[ 1 ];
-	uint64_t Seed3 = ctx -> Seed[ 2 ];
-	uint64_t Seed4 = ctx -> Seed[ 3 ];
-	uint64_t Seed5 = ctx -> Seed[ 4 ];
-	uint64_t Seed6 = ctx -> Seed[ 5 ];
-	uint64_t Seed7 = ctx -> Seed[ 6 ];
-	uint64_t Seed8 = ctx -> Seed[ 7 ];
+	uint64_t Seed1 = key -> Seed[ 0 ];
+	uint64_t Seed2 = key -> Seed[ 1 ];
+	uint64_t Seed3 = key -> Seed[ 2 ];
+	uint64_t Seed4 = key -> Seed[ 3 ];
+	uint64_t Seed5 = key -> Seed[ 4 ];
+	uint64_t Seed6 = key -> Seed[ 5 ];
+	uint64_t Seed7 = key -> Seed[ 6 ];
+	uint64_t Seed8 = key -> Seed[ 7 ];
 
-	if( MsgLen > 63 )
-	{
-		KOMIHASH_HASHLOOP64();
-	}
+	KOMIHASH_HASHLOOP64();
 
 	Seed5 ^= Seed6 ^ Seed7 ^ Seed8;
 	Seed1 ^= Seed2 ^ Seed3 ^ Seed4;
@@ -951,23 +1343,3330 @@ static inline uint64_t komihash_stream_final( komihash_stream_t* const ctx )
 }
 
 /**
- * @brief FOR TESTING PURPOSES ONLY - use the komihash() function instead.
+ * @brief KOMIHASH 64-bit hash function, for a 32-bit value.
  *
- * @param Msg The message to produce a hash from.
- * @param MsgLen Message's length, in bytes.
- * @param UseSeed Seed to use.
+ * Returns a value equal to the value returned by the komihash() function for
+ * a 4-byte little-endian representation of the value, on both big- and
+ * little-endian systems. The value is hashed without a memory round-trip,
+ * and without message length branching.
+ *
+ * @param v Value to hash.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
  * @return 64-bit hash value.
  */
 
-static inline uint64_t komihash_stream_oneshot( const void* const Msg,
-	const size_t MsgLen, const uint64_t UseSeed )
+static inline uint64_t komihash_u32( const uint32_t v, const uint64_t UseSeed )
 {
-	komihash_stream_t ctx;
+	KOMIHASH_SEEDINIT();
 
-	komihash_stream_init( &ctx, UseSeed );
-	komihash_stream_update( &ctx, Msg, MsgLen );
+	const uint64_t r1h = Seed1 ^ ( (uint64_t) 1 << 32 | v );
+	const uint64_t r2h = Seed5;
 
-	return( komihash_stream_final( &ctx ));
+	KOMIHASH_HASHFIN();
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for a 64-bit value.
+ *
+ * Returns a value equal to the value returned by the komihash() function for
+ * an 8-byte little-endian representation of the value, on both big- and
+ * little-endian systems.
+ *
+ * @param v Value to hash.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ * @return 64-bit hash value.
+ */
+
+static inline uint64_t komihash_u64( const uint64_t v, const uint64_t UseSeed )
+{
+	KOMIHASH_SEEDINIT();
+
+	const uint64_t r1h = Seed1 ^ v;
+	const uint64_t r2h = Seed5 ^ 1;
+
+	KOMIHASH_HASHFIN();
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for a pair of 64-bit values.
+ *
+ * Returns a value equal to the value returned by the komihash() function for
+ * a 16-byte little-endian representation of the `{ v1, v2 }` array, on both
+ * big- and little-endian systems. Can be used to hash UUIDs that are
+ * available as two 64-bit halves.
+ *
+ * @param v1 The first value to hash.
+ * @param v2 The second value to hash.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ * @return 64-bit hash value.
+ */
+
+static inline uint64_t komihash_2x64( const uint64_t v1, const uint64_t v2,
+	const uint64_t UseSeed )
+{
+	KOMIHASH_SEEDINIT();
+
+	kh_m128( Seed1 ^ v1, Seed5 ^ v2, &Seed1, &Seed5 );
+	Seed1 ^= Seed5;
+
+	const uint64_t r1h = Seed1 ^ 1;
+	const uint64_t r2h = Seed5;
+
+	KOMIHASH_HASHFIN();
+}
+
+#if defined( __SIZEOF_INT128__ )
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for a 128-bit value.
+ *
+ * Returns a value equal to the value returned by the komihash() function for
+ * a 16-byte little-endian representation of the value, on both big- and
+ * little-endian systems. Available if the compiler supports the
+ * `unsigned __int128` type.
+ *
+ * @param v Value to hash.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ * @return 64-bit hash value.
+ */
+
+__extension__ typedef unsigned __int128 kh_u128_t; ///< For `-Wpedantic`.
+
+static inline uint64_t komihash_u128( const kh_u128_t v,
+	const uint64_t UseSeed )
+{
+	return( komihash_2x64( (uint64_t) v, (uint64_t) ( v >> 64 ), UseSeed ));
 }
 
+#endif // defined( __SIZEOF_INT128__ )
+
+/**
+ * @def KOMIHASH_MULTI_LANES
+ * @brief The maximal number of seeds the komihash_multi() function hashes
+ * a message with in a single pass.
+ */
+
+#define KOMIHASH_MULTI_LANES 4
+
+/**
+ * @def KOMIHASH_MULTI_EACH( L, s )
+ * @brief Macro expands the `s` statements for each of `L` lanes, with the
+ * `j` variable set to lane's index (for internal use). Unlike a loop, this
+ * makes lane indices constant, so that lane arrays are kept in registers.
+ * Expects `L` to not exceed KOMIHASH_MULTI_LANES.
+ */
+
+#define KOMIHASH_MULTI_EACH( L, s ) \
+	{ j = 0; s } \
+	if( (L) > 1 ) { j = 1; s } \
+	if( (L) > 2 ) { j = 2; s } \
+	if( (L) > 3 ) { j = 3; s }
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for several messages of the same
+ * length, or for several seeds, at once (for internal use).
+ *
+ * Hashes `L` messages placed `Stride` bytes apart, interleaving `L`
+ * independent hashing states. Since all messages have the same length, all
+ * lanes take the same branches. If `Stride` is 0, the same message is
+ * hashed with `L` initial states (seeds), loading each message's word once.
+ *
+ * @param Msg Pointer to the first message, alignment is unimportant.
+ * @param Stride The distance between messages, in bytes, can be zero.
+ * @param MsgLen Messages' length, in bytes, can be zero.
+ * @param Seed1s Initial Seed1 values, `L` elements.
+ * @param Seed5s Initial Seed5 values, `L` elements.
+ * @param[out] out Resulting hash values, `L` elements.
+ * @param L The number of lanes, not above KOMIHASH_MULTI_LANES; expected to
+ * be a compile-time constant.
+ */
+
+static KOMIHASH_INLINE void kh_multi( const uint8_t* Msg, const size_t Stride,
+	size_t MsgLen, const uint64_t* const Seed1s,
+	const uint64_t* const Seed5s, uint64_t* const out, const int L )
+{
+	uint64_t S1[ KOMIHASH_MULTI_LANES ];
+	uint64_t S5[ KOMIHASH_MULTI_LANES ];
+	uint64_t M1[ KOMIHASH_MULTI_LANES ];
+	uint64_t M2[ KOMIHASH_MULTI_LANES ];
+	int j;
+
+	KOMIHASH_MULTI_EACH( L,
+		S1[ j ] = Seed1s[ j ];
+		S5[ j ] = Seed5s[ j ]; );
+
+	KOMIHASH_PREFETCH( Msg );
+
+	if( KOMIHASH_LIKELY( MsgLen < 16 ))
+	{
+		KOMIHASH_MULTI_EACH( L,
+			const uint8_t* const m = Msg + Stride * (size_t) j;
+
+			M1[ j ] = 0;
+			M2[ j ] = 0;
+
+			if( MsgLen > 7 )
+			{
+				M2[ j ] = kh_lpu64ec_l3( m + 8, MsgLen - 8 );
+				M1[ j ] = kh_lu64ec( m );
+			}
+			else
+			if( KOMIHASH_LIKELY( MsgLen != 0 ))
+			{
+				M1[ j ] = kh_lpu64ec_nz( m, MsgLen );
+			} );
+	}
+	else
+	{
+		if( KOMIHASH_LIKELY( MsgLen > 63 ))
+		{
+			uint64_t S2[ KOMIHASH_MULTI_LANES ];
+			uint64_t S3[ KOMIHASH_MULTI_LANES ];
+			uint64_t S4[ KOMIHASH_MULTI_LANES ];
+			uint64_t S6[ KOMIHASH_MULTI_LANES ];
+			uint64_t S7[ KOMIHASH_MULTI_LANES ];
+			uint64_t S8[ KOMIHASH_MULTI_LANES ];
+
+			KOMIHASH_MULTI_EACH( L,
+				S2[ j ] = 0x13198A2E03707344 ^ S1[ j ];
+				S3[ j ] = 0xA4093822299F31D0 ^ S1[ j ];
+				S4[ j ] = 0x082EFA98EC4E6C89 ^ S1[ j ];
+				S6[ j ] = 0xBE5466CF34E90C6C ^ S5[ j ];
+				S7[ j ] = 0xC0AC29B7C97C50DD ^ S5[ j ];
+				S8[ j ] = 0x3F84D5B5B5470917 ^ S5[ j ]; );
+
+			do
+			{
+				KOMIHASH_PREFETCH_1( Msg );
+
+				KOMIHASH_MULTI_EACH( L,
+					const uint8_t* const m = Msg + Stride * (size_t) j;
+
+					kh_m128( S1[ j ] ^ kh_lu64ec( m ),
+						S5[ j ] ^ kh_lu64ec( m + 32 ), &S1[ j ], &S5[ j ]);
+
+					kh_m128( S2[ j ] ^ kh_lu64ec( m + 8 ),
+						S6[ j ] ^ kh_lu64ec( m + 40 ), &S2[ j ], &S6[ j ]);
+
+					kh_m128( S3[ j ] ^ kh_lu64ec( m + 16 ),
+						S7[ j ] ^ kh_lu64ec( m + 48 ), &S3[ j ], &S7[ j ]);
+
+					kh_m128( S4[ j ] ^ kh_lu64ec( m + 24 ),
+						S8[ j ] ^ kh_lu64ec( m + 56 ), &S4[ j ], &S8[ j ]);
+
+					S2[ j ] ^= S5[ j ];
+					S3[ j ] ^= S6[ j ];
+					S4[ j ] ^= S7[ j ];
+					S1[ j ] ^= S8[ j ]; );
+
+				Msg += 64;
+				MsgLen -= 64;
+
+				KOMIHASH_PREFETCH_2( Msg );
+
+			} while( KOMIHASH_LIKELY( MsgLen > 63 ));
+
+			KOMIHASH_MULTI_EACH( L,
+				S5[ j ] ^= S6[ j ] ^ S7[ j ] ^ S8[ j ];
+				S1[ j ] ^= S2[ j ] ^ S3[ j ] ^ S4[ j ]; );
+		}
+
+		// The komihash_epi() function's logic, which is also equivalent to
+		// the 16-31-byte branch of the komihash_body() function.
+
+		while( MsgLen > 15 )
+		{
+			KOMIHASH_MULTI_EACH( L,
+				const uint8_t* const m = Msg + Stride * (size_t) j;
+
+				kh_m128( S1[ j ] ^ kh_lu64ec( m ),
+					S5[ j ] ^ kh_lu64ec( m + 8 ), &S1[ j ], &S5[ j ]);
+
+				S1[ j ] ^= S5[ j ]; );
+
+			Msg += 16;
+			MsgLen -= 16;
+		}
+
+		KOMIHASH_MULTI_EACH( L,
+			const uint8_t* const m = Msg + Stride * (size_t) j;
+
+			if( MsgLen > 7 )
+			{
+				M2[ j ] = kh_lpu64ec_l4( m + 8, MsgLen - 8 );
+				M1[ j ] = kh_lu64ec( m );
+			}
+			else
+			{
+				M1[ j ] = kh_lpu64ec_l4( m, MsgLen );
+				M2[ j ] = 0;
+			} );
+	}
+
+	KOMIHASH_MULTI_EACH( L,
+		uint64_t Seed1 = S1[ j ] ^ M1[ j ];
+		uint64_t Seed5 = S5[ j ];
+
+		kh_m128( Seed1, Seed5 ^ M2[ j ], &Seed1, &Seed5 );
+		Seed1 ^= Seed5;
+
+		KOMIHASH_HASHROUND();
+
+		out[ j ] = Seed1; );
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for several seeds at once (for
+ * internal use).
+ *
+ * @param Msg Message pointer, alignment is unimportant.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param Seeds Seed values, `L` elements.
+ * @param[out] out Resulting hash values, `L` elements.
+ * @param L The number of seeds, not above KOMIHASH_MULTI_LANES; expected to
+ * be a compile-time constant.
+ */
+
+static KOMIHASH_INLINE void kh_multi_seeds( const uint8_t* const Msg,
+	const size_t MsgLen, const uint64_t* const Seeds, uint64_t* const out,
+	const int L )
+{
+	uint64_t Seed1s[ KOMIHASH_MULTI_LANES ];
+	uint64_t Seed5s[ KOMIHASH_MULTI_LANES ];
+	int j;
+
+	KOMIHASH_MULTI_EACH( L,
+		const uint64_t UseSeed = Seeds[ j ];
+		KOMIHASH_SEEDINIT();
+
+		Seed1s[ j ] = Seed1;
+		Seed5s[ j ] = Seed5; );
+
+	kh_multi( Msg, 0, MsgLen, Seed1s, Seed5s, out, L );
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for several seeds at once.
+ *
+ * Produces `k` 64-bit hash values of the same message, one per seed (e.g.,
+ * for Bloom filters and count-min sketches). Every resulting value is equal
+ * to the value returned by the komihash() function for the same message and
+ * the respective seed.
+ *
+ * Up to KOMIHASH_MULTI_LANES seeds are processed in a single pass over the
+ * message: each message's word is loaded once, and the hashing states of
+ * all seeds are updated in an interleaved manner, hiding the latency of
+ * `kh_m128()` multiply chains.
+ *
+ * @param Msg0 The message to produce hashes from. The alignment of this
+ * pointer is unimportant.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param Seeds Seed values, `k` elements, the same as the `UseSeed` value of
+ * the komihash() function.
+ * @param k The number of seeds, can be zero.
+ * @param[out] out Resulting hash values, `k` elements.
+ */
+
+static inline void komihash_multi( const void* const Msg0,
+	const size_t MsgLen, const uint64_t* Seeds, int k, uint64_t* out )
+{
+	const uint8_t* const Msg = (const uint8_t*) Msg0;
+
+	while( k >= KOMIHASH_MULTI_LANES )
+	{
+		kh_multi_seeds( Msg, MsgLen, Seeds, out, KOMIHASH_MULTI_LANES );
+
+		Seeds += KOMIHASH_MULTI_LANES;
+		out += KOMIHASH_MULTI_LANES;
+		k -= KOMIHASH_MULTI_LANES;
+	}
+
+	if( k >= 2 )
+	{
+		kh_multi_seeds( Msg, MsgLen, Seeds, out, 2 );
+
+		Seeds += 2;
+		out += 2;
+		k -= 2;
+	}
+
+	if( k > 0 )
+	{
+		*out = komihash( Msg, MsgLen, *Seeds );
+	}
+}
+
+/**
+ * @def KOMIHASH_STRIDED_LANES
+ * @brief The number of records the komihash_strided() function hashes in an
+ * interleaved manner, not above KOMIHASH_MULTI_LANES.
+ */
+
+#define KOMIHASH_STRIDED_LANES 4
+
+/**
+ * @def KOMIHASH_STRIDED_PFAHEAD
+ * @brief The number of records ahead the komihash_strided() function
+ * prefetches fields of. Can be defined externally; 0 disables the prefetch.
+ */
+
+#if !defined( KOMIHASH_STRIDED_PFAHEAD )
+	#define KOMIHASH_STRIDED_PFAHEAD 8
+#endif // !defined( KOMIHASH_STRIDED_PFAHEAD )
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for a field of an array of records.
+ *
+ * Produces 64-bit hash values of a fixed-length field in each record of an
+ * array of structures, without gathering fields into a temporary buffer.
+ * Every resulting value is equal to the value returned by the komihash()
+ * function for the same field and seed.
+ *
+ * The seed initialization round is performed only once. Fields of
+ * KOMIHASH_STRIDED_LANES records are hashed at once, with independent
+ * interleaved hashing states, hiding the latency of `kh_m128()` multiply
+ * chains; since the field's length is the same for all records, all lanes
+ * take the same branches. Fields are prefetched KOMIHASH_STRIDED_PFAHEAD
+ * records ahead.
+ *
+ * @param Base Pointer to the first record. The alignment of this pointer is
+ * unimportant.
+ * @param Stride The distance between records, in bytes.
+ * @param FieldOffset Field's offset within the record, in bytes.
+ * @param FieldLen Field's length, in bytes, can be zero.
+ * @param Count The number of records.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ * @param[out] out Resulting hash values, `Count` elements.
+ */
+
+static inline void komihash_strided( const void* const Base,
+	const size_t Stride, const size_t FieldOffset, const size_t FieldLen,
+	size_t Count, const uint64_t UseSeed, uint64_t* out )
+{
+	KOMIHASH_SEEDINIT();
+
+	const uint64_t Seed1s[ KOMIHASH_STRIDED_LANES ] = { Seed1, Seed1, Seed1,
+		Seed1 };
+
+	const uint64_t Seed5s[ KOMIHASH_STRIDED_LANES ] = { Seed5, Seed5, Seed5,
+		Seed5 };
+
+	const uint8_t* Msg = (const uint8_t*) Base + FieldOffset;
+
+	#if KOMIHASH_STRIDED_PFAHEAD > 0
+
+	const size_t FieldLast = FieldLen - ( FieldLen != 0 );
+	const size_t PfDist = Stride * KOMIHASH_STRIDED_PFAHEAD;
+	size_t i;
+
+	#endif // KOMIHASH_STRIDED_PFAHEAD > 0
+
+	while( Count >= KOMIHASH_STRIDED_LANES )
+	{
+		#if KOMIHASH_STRIDED_PFAHEAD > 0
+
+		if( Count >= KOMIHASH_STRIDED_PFAHEAD + KOMIHASH_STRIDED_LANES )
+		{
+			for( i = 0; i < KOMIHASH_STRIDED_LANES; i++ )
+			{
+				const uint8_t* const pf = Msg + PfDist + Stride * i;
+
+				KOMIHASH_PREFETCH( pf );
+				KOMIHASH_PREFETCH( pf + FieldLast );
+			}
+		}
+
+		#endif // KOMIHASH_STRIDED_PFAHEAD > 0
+
+		kh_multi( Msg, Stride, FieldLen, Seed1s, Seed5s, out,
+			KOMIHASH_STRIDED_LANES );
+
+		Msg += Stride * KOMIHASH_STRIDED_LANES;
+		out += KOMIHASH_STRIDED_LANES;
+		Count -= KOMIHASH_STRIDED_LANES;
+	}
+
+	if( Count >= 2 )
+	{
+		kh_multi( Msg, Stride, FieldLen, Seed1s, Seed5s, out, 2 );
+
+		Msg += Stride * 2;
+		out += 2;
+		Count -= 2;
+	}
+
+	if( Count > 0 )
+	{
+		*out = komihash_body( Msg, FieldLen, Seed1, Seed5 );
+	}
+}
+
+/**
+ * @def KOMIHASH_PTRS_PFAHEAD
+ * @brief The number of messages ahead the komihash_ptrs() function
+ * prefetches data of. Can be defined externally; 0 disables the prefetch.
+ */
+
+#if !defined( KOMIHASH_PTRS_PFAHEAD )
+	#define KOMIHASH_PTRS_PFAHEAD 16
+#endif // !defined( KOMIHASH_PTRS_PFAHEAD )
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for an array of scattered messages,
+ * with software-pipelined prefetch.
+ *
+ * Produces 64-bit hash values of a set of independent messages (e.g.,
+ * hash-map lookup keys) scattered in memory, all hashed with the same seed.
+ * Every resulting value is equal to the value returned by the komihash()
+ * function for the same message and seed.
+ *
+ * The seed initialization round is performed only once, and the first and
+ * the last bytes of each message are prefetched KOMIHASH_PTRS_PFAHEAD
+ * messages ahead, so that the cache miss at the start of each message is
+ * overlapped with the hashing of preceding messages. Optionally, bucket
+ * indices of a power-of-two hash-table are produced as well, which the
+ * caller may use to prefetch the buckets before probing them.
+ *
+ * @param Msgs Pointers to messages. The alignment of these pointers is
+ * unimportant.
+ * @param MsgLens Messages' lengths, in bytes, can be zero.
+ * @param n The number of messages to hash.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ * @param[out] out Resulting hash values, `n` elements.
+ * @param TableSize Hash-table's size, in buckets, should be a power of 2.
+ * Ignored if `Buckets` is 0.
+ * @param[out] Buckets Resulting bucket indices, `n` elements, equal to
+ * `out[ i ] & ( TableSize - 1 )`. Can be 0, if not needed.
+ */
+
+static inline void komihash_ptrs( const void* const* const Msgs,
+	const size_t* const MsgLens, const size_t n, const uint64_t UseSeed,
+	uint64_t* const out, const size_t TableSize, size_t* const Buckets )
+{
+	KOMIHASH_SEEDINIT();
+
+	const size_t BucketMask = TableSize - 1;
+	size_t i;
+
+	#if KOMIHASH_PTRS_PFAHEAD > 0
+
+	for( i = 0; i < n && i < KOMIHASH_PTRS_PFAHEAD; i++ )
+	{
+		const uint8_t* const pf = (const uint8_t*) Msgs[ i ];
+		const size_t pfl = MsgLens[ i ];
+
+		KOMIHASH_PREFETCH( pf );
+		KOMIHASH_PREFETCH( pf + ( pfl - ( pfl != 0 )));
+	}
+
+	#endif // KOMIHASH_PTRS_PFAHEAD > 0
+
+	for( i = 0; i < n; i++ )
+	{
+		#if KOMIHASH_PTRS_PFAHEAD > 0
+
+		if( KOMIHASH_LIKELY( i + KOMIHASH_PTRS_PFAHEAD < n ))
+		{
+			const uint8_t* const pf =
+				(const uint8_t*) Msgs[ i + KOMIHASH_PTRS_PFAHEAD ];
+
+			const size_t pfl = MsgLens[ i + KOMIHASH_PTRS_PFAHEAD ];
+
+			KOMIHASH_PREFETCH( pf );
+			KOMIHASH_PREFETCH( pf + ( pfl - ( pfl != 0 )));
+		}
+
+		#endif // KOMIHASH_PTRS_PFAHEAD > 0
+
+		const uint64_t h = komihash_body( (const uint8_t*) Msgs[ i ],
+			MsgLens[ i ], Seed1, Seed5 );
+
+		out[ i ] = h;
+
+		if( Buckets != 0 )
+		{
+			Buckets[ i ] = (size_t) h & BucketMask;
+		}
+	}
+}
+
+/**
+ * @def KOMIHASH_BULK_PFDIST
+ * @brief The prefetch distance, in bytes, used by the komihash_bulk()
+ * function.
+ *
+ * Message data is prefetched this many bytes ahead of the hashing position,
+ * so that hashing of messages that do not fit CPU cache is not stalled by
+ * memory latency. The prefetch's temporal locality is specified by the
+ * KOMIHASH_BULK_PFLOC macro. 0 disables such prefetching. Should be a
+ * multiple of 64. Can be defined externally. Not used on 32-bit x86 with
+ * SSE2, where the SSE2 hashing loop is used instead.
+ */
+
+#if !defined( KOMIHASH_BULK_PFDIST )
+
+	#define KOMIHASH_BULK_PFDIST 4096
+
+#endif // !defined( KOMIHASH_BULK_PFDIST )
+
+/**
+ * @brief The 64-byte hashing loop (for internal use).
+ *
+ * @param[in,out] pMsg Pointer to the message pointer, advanced on return.
+ * @param[in,out] pMsgLen Pointer to the message length (greater than 63),
+ * decreased on return.
+ * @param[in,out] Seed Hashing state variables, `Seed1-8`.
+ */
+
+static KOMIHASH_INLINE void kh_loop64_body( const uint8_t** const pMsg,
+	size_t* const pMsgLen, uint64_t* const Seed )
+{
+	const uint8_t* Msg = *pMsg;
+	size_t MsgLen = *pMsgLen;
+
+	uint64_t Seed1 = Seed[ 0 ];
+	uint64_t Seed2 = Seed[ 1 ];
+	uint64_t Seed3 = Seed[ 2 ];
+	uint64_t Seed4 = Seed[ 3 ];
+	uint64_t Seed5 = Seed[ 4 ];
+	uint64_t Seed6 = Seed[ 5 ];
+	uint64_t Seed7 = Seed[ 6 ];
+	uint64_t Seed8 = Seed[ 7 ];
+
+#if KOMIHASH_BULK_PFDIST > 0 && !defined( KOMIHASH_SSE2_M128 )
+
+	while( KOMIHASH_LIKELY( MsgLen > KOMIHASH_BULK_PFDIST + 63 ))
+	{
+		KOMIHASH_PREFETCH_BULK( Msg + KOMIHASH_BULK_PFDIST );
+
+		KOMIHASH_HASH64( Msg, Seed1, Seed2, Seed3, Seed4,
+			Seed5, Seed6, Seed7, Seed8 );
+
+		Msg += 64;
+		MsgLen -= 64;
+	}
+
+	if( MsgLen > 63 )
+	{
+		KOMIHASH_HASHLOOP64();
+	}
+
+#else // KOMIHASH_BULK_PFDIST > 0 && !defined( KOMIHASH_SSE2_M128 )
+
+	KOMIHASH_HASHLOOP64();
+
+#endif // KOMIHASH_BULK_PFDIST > 0 && !defined( KOMIHASH_SSE2_M128 )
+
+	Seed[ 0 ] = Seed1;
+	Seed[ 1 ] = Seed2;
+	Seed[ 2 ] = Seed3;
+	Seed[ 3 ] = Seed4;
+	Seed[ 4 ] = Seed5;
+	Seed[ 5 ] = Seed6;
+	Seed[ 6 ] = Seed7;
+	Seed[ 7 ] = Seed8;
+
+	*pMsg = Msg;
+	*pMsgLen = MsgLen;
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for large messages.
+ *
+ * Returns a value equal to the value returned by the komihash() function.
+ * Message data is prefetched ahead, as specified by the KOMIHASH_BULK_PFDIST
+ * macro. For short messages (less than 256 bytes), the komihash() function
+ * is used.
+ *
+ * @param Msg0 The message to produce a hash from. The alignment of this
+ * pointer is unimportant.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ * @return 64-bit hash of the input data.
+ */
+
+static inline uint64_t komihash_bulk( const void* const Msg0, size_t MsgLen,
+	const uint64_t UseSeed )
+{
+	if( MsgLen < 256 )
+	{
+		return( komihash( Msg0, MsgLen, UseSeed ));
+	}
+
+	const uint8_t* Msg = (const uint8_t*) Msg0;
+	komihash_key_t key;
+
+	KOMIHASH_PREFETCH( Msg );
+
+	komihash_key_init( &key, UseSeed );
+
+	kh_loop64_body( &Msg, &MsgLen, key.Seed );
+
+	const uint64_t Seed5 = key.Seed[ 4 ] ^ key.Seed[ 5 ] ^ key.Seed[ 6 ] ^
+		key.Seed[ 7 ];
+
+	const uint64_t Seed1 = key.Seed[ 0 ] ^ key.Seed[ 1 ] ^ key.Seed[ 2 ] ^
+		key.Seed[ 3 ];
+
+	return( komihash_epi( Msg, MsgLen, Seed1, Seed5 ));
+}
+
+/**
+ * @brief Function hashes a column of strings, with either 32- or 64-bit
+ * offsets (for internal use).
+ *
+ * @param Data Strings' data buffer.
+ * @param Offsets32 32-bit offsets, `Rows + 1` elements, or 0.
+ * @param Offsets64 64-bit offsets, `Rows + 1` elements, or 0.
+ * @param Rows The number of rows.
+ * @param UseSeed Seed value.
+ * @param Validity Validity bitmap, or 0.
+ * @param NullHash Hash value of null rows.
+ * @param[out] out Resulting hash values, `Rows` elements.
+ */
+
+static KOMIHASH_INLINE void kh_column_strings( const uint8_t* const Data,
+	const int32_t* const Offsets32, const int64_t* const Offsets64,
+	const size_t Rows, const uint64_t UseSeed, const uint8_t* const Validity,
+	const uint64_t NullHash, uint64_t* const out )
+{
+	#define KOMIHASH_COLOFFS( i ) ( Offsets32 != 0 ? \
+		(size_t) Offsets32[ i ] : (size_t) Offsets64[ i ])
+
+	#define KOMIHASH_COLNULL( i ) ( Validity != 0 && \
+		( Validity[ ( i ) >> 3 ] >> (( i ) & 7 ) & 1 ) == 0 )
+
+	const size_t DataEnd = KOMIHASH_COLOFFS( Rows );
+	size_t i = 0;
+
+	// Strings followed by at least 16 bytes of subsequent strings' data are
+	// hashed via komihash_padded(), without per-byte-count branching. Null
+	// rows are not hashed.
+
+	while( i < Rows )
+	{
+		const size_t s = KOMIHASH_COLOFFS( i );
+		const size_t e = KOMIHASH_COLOFFS( i + 1 );
+
+		if( e + 16 > DataEnd )
+		{
+			break;
+		}
+
+		if( i + 8 < Rows )
+		{
+			KOMIHASH_PREFETCH( Data + KOMIHASH_COLOFFS( i + 8 ));
+		}
+
+		out[ i ] = ( KOMIHASH_COLNULL( i ) ? NullHash :
+			komihash_padded( Data + s, e - s, UseSeed ));
+
+		i++;
+	}
+
+	while( i < Rows )
+	{
+		const size_t s = KOMIHASH_COLOFFS( i );
+		const size_t e = KOMIHASH_COLOFFS( i + 1 );
+
+		out[ i ] = ( KOMIHASH_COLNULL( i ) ? NullHash :
+			komihash( Data + s, e - s, UseSeed ));
+
+		i++;
+	}
+
+	#undef KOMIHASH_COLNULL
+	#undef KOMIHASH_COLOFFS
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for a column of strings with 64-bit
+ * offsets, with a validity bitmap.
+ *
+ * Produces values equal to the values returned by the komihash() function
+ * for each row's string. The column is expected to be stored in the
+ * "Apache Arrow" layout: a contiguous data buffer, and an offsets array with
+ * `Rows + 1` elements. Short strings are hashed with only a 16-byte
+ * length-class branch, instead of per-byte-count branching, by over-reading
+ * the data of subsequent strings (over-reading beyond the column's data is
+ * not performed).
+ *
+ * @param Data Strings' data buffer.
+ * @param Offsets Offsets of strings in the data buffer, `Rows + 1`
+ * elements.
+ * @param Rows The number of rows.
+ * @param UseSeed Optional value, to use instead of the default seed.
+ * @param Validity Validity bitmap (least-significant bit first, bit=1 marks a
+ * valid row), or 0 if all rows are valid.
+ * @param NullHash Hash value to output for null rows.
+ * @param[out] out Resulting hash values, `Rows` elements.
+ */
+
+static inline void komihash_column_strings_v( const uint8_t* const Data,
+	const int64_t* const Offsets, const size_t Rows, const uint64_t UseSeed,
+	const uint8_t* const Validity, const uint64_t NullHash,
+	uint64_t* const out )
+{
+	kh_column_strings( Data, 0, Offsets, Rows, UseSeed, Validity, NullHash,
+		out );
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for a column of strings with 32-bit
+ * offsets, with a validity bitmap.
+ *
+ * Equivalent to the komihash_column_strings_v() function, but accepts
+ * 32-bit offsets.
+ *
+ * @param Data Strings' data buffer.
+ * @param Offsets Offsets of strings in the data buffer, `Rows + 1`
+ * elements.
+ * @param Rows The number of rows.
+ * @param UseSeed Optional value, to use instead of the default seed.
+ * @param Validity Validity bitmap, or 0 if all rows are valid.
+ * @param NullHash Hash value to output for null rows.
+ * @param[out] out Resulting hash values, `Rows` elements.
+ */
+
+static inline void komihash_column_strings32_v( const uint8_t* const Data,
+	const int32_t* const Offsets, const size_t Rows, const uint64_t UseSeed,
+	const uint8_t* const Validity, const uint64_t NullHash,
+	uint64_t* const out )
+{
+	kh_column_strings( Data, Offsets, 0, Rows, UseSeed, Validity, NullHash,
+		out );
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for a column of strings with 64-bit
+ * offsets.
+ *
+ * Equivalent to the komihash_column_strings_v() function, for a column
+ * without null rows.
+ *
+ * @param Data Strings' data buffer.
+ * @param Offsets Offsets of strings in the data buffer, `Rows + 1`
+ * elements.
+ * @param Rows The number of rows.
+ * @param UseSeed Optional value, to use instead of the default seed.
+ * @param[out] out Resulting hash values, `Rows` elements.
+ */
+
+static inline void komihash_column_strings( const uint8_t* const Data,
+	const int64_t* const Offsets, const size_t Rows, const uint64_t UseSeed,
+	uint64_t* const out )
+{
+	kh_column_strings( Data, 0, Offsets, Rows, UseSeed, 0, 0, out );
+}
+
+/**
+ * @def KOMIHASH_VALIDMASK( Validity, i )
+ * @brief Macro returns a 64-bit mask of row's validity: all-ones if the row
+ * is valid, or 0 if the row is null.
+ * @param Validity Validity bitmap (least-significant bit first), or 0 if all
+ * rows are valid.
+ * @param i Row's index.
+ */
+
+#define KOMIHASH_VALIDMASK( Validity, i ) ( (Validity) == 0 ? ~(uint64_t) 0 : \
+	(uint64_t) 0 - (uint64_t) ( (Validity)[ (i) >> 3 ] >> ( (i) & 7 ) & 1 ))
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for a 32-bit value or a null value
+ * (for internal use).
+ *
+ * @param v Value to hash.
+ * @param vm Validity mask: all-ones if the value is valid, 0 if the value is
+ * null (hashed as an empty message).
+ * @param UseSeed Seed value.
+ * @return 64-bit hash value.
+ */
+
+static KOMIHASH_INLINE uint64_t kh_fold32( const uint32_t v,
+	const uint64_t vm, const uint64_t UseSeed )
+{
+	KOMIHASH_SEEDINIT();
+
+	const uint64_t r1h = Seed1 ^ (( (uint64_t) 1 << 32 | v ) & vm );
+	const uint64_t r2h = Seed5;
+
+	KOMIHASH_HASHFIN();
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for a 64-bit value or a null value
+ * (for internal use).
+ *
+ * @param v Value to hash.
+ * @param vm Validity mask: all-ones if the value is valid, 0 if the value is
+ * null (hashed as an empty message).
+ * @param UseSeed Seed value.
+ * @return 64-bit hash value.
+ */
+
+static KOMIHASH_INLINE uint64_t kh_fold64( const uint64_t v,
+	const uint64_t vm, const uint64_t UseSeed )
+{
+	KOMIHASH_SEEDINIT();
+
+	const uint64_t r1h = Seed1 ^ ( v & vm );
+	const uint64_t r2h = Seed5 ^ ( 1 & vm );
+
+	KOMIHASH_HASHFIN();
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for a pair of 64-bit values or a
+ * null value (for internal use).
+ *
+ * The 16-byte hashing round is performed for null values as well, and its
+ * result is discarded via masking, without branching.
+ *
+ * @param v1 The first value to hash.
+ * @param v2 The second value to hash.
+ * @param vm Validity mask: all-ones if the value is valid, 0 if the value is
+ * null (hashed as an empty message).
+ * @param UseSeed Seed value.
+ * @return 64-bit hash value.
+ */
+
+static KOMIHASH_INLINE uint64_t kh_fold128( const uint64_t v1,
+	const uint64_t v2, const uint64_t vm, const uint64_t UseSeed )
+{
+	KOMIHASH_SEEDINIT();
+
+	uint64_t s1;
+	uint64_t s5 = Seed5;
+
+	kh_m128( Seed1 ^ v1, Seed5 ^ v2, &s1, &s5 );
+	s1 ^= s5;
+
+	const uint64_t r1h = (( s1 ^ 1 ) & vm ) | ( Seed1 & ~vm );
+	const uint64_t r2h = ( s5 & vm ) | ( Seed5 & ~vm );
+	Seed5 = r2h;
+
+	KOMIHASH_HASHFIN();
+}
+
+/**
+ * @brief Function folds a column of 32-bit integer values into per-row hash
+ * values.
+ *
+ * For each row, the resulting hash value is equal to the value returned by
+ * the komihash_u32() function (or komihash() of value's little-endian
+ * representation) with the row's current hash value used as the seed, as in
+ * the discrete-incremental hashing. Null rows are hashed as empty messages,
+ * i.e., `komihash( 0, 0, h[ i ])`. Several columns can be combined into a
+ * single row hash by folding them into the same hash array, which should be
+ * initialized to the seed value.
+ *
+ * @param Col Column's values.
+ * @param Rows The number of rows.
+ * @param Validity Validity bitmap (least-significant bit first, bit=1 marks a
+ * valid row), or 0 if all rows are valid.
+ * @param[in,out] h Per-row hash values, `Rows` elements.
+ */
+
+static inline void komihash_column_fold_i32( const int32_t* const Col,
+	const size_t Rows, const uint8_t* const Validity, uint64_t* const h )
+{
+	size_t i;
+
+	for( i = 0; i < Rows; i++ )
+	{
+		h[ i ] = kh_fold32( (uint32_t) Col[ i ],
+			KOMIHASH_VALIDMASK( Validity, i ), h[ i ]);
+	}
+}
+
+/**
+ * @brief Function folds a column of 64-bit integer values into per-row hash
+ * values.
+ *
+ * Equivalent to the komihash_column_fold_i32() function, for 64-bit values
+ * (komihash_u64()).
+ *
+ * @param Col Column's values.
+ * @param Rows The number of rows.
+ * @param Validity Validity bitmap, or 0 if all rows are valid.
+ * @param[in,out] h Per-row hash values, `Rows` elements.
+ */
+
+static inline void komihash_column_fold_i64( const int64_t* const Col,
+	const size_t Rows, const uint8_t* const Validity, uint64_t* const h )
+{
+	size_t i;
+
+	for( i = 0; i < Rows; i++ )
+	{
+		h[ i ] = kh_fold64( (uint64_t) Col[ i ],
+			KOMIHASH_VALIDMASK( Validity, i ), h[ i ]);
+	}
+}
+
+/**
+ * @brief Function folds a column of double-precision floating-point values
+ * into per-row hash values.
+ *
+ * Equivalent to the komihash_column_fold_i64() function applied to values'
+ * IEEE 754 bit representations, after canonicalization: -0.0 is hashed as
+ * 0.0, and all NaN values are hashed as the 0x7FF8000000000000 quiet NaN.
+ *
+ * @param Col Column's values.
+ * @param Rows The number of rows.
+ * @param Validity Validity bitmap, or 0 if all rows are valid.
+ * @param[in,out] h Per-row hash values, `Rows` elements.
+ */
+
+static inline void komihash_column_fold_f64( const double* const Col,
+	const size_t Rows, const uint8_t* const Validity, uint64_t* const h )
+{
+	size_t i;
+
+	for( i = 0; i < Rows; i++ )
+	{
+		uint64_t v;
+		memcpy( &v, Col + i, 8 );
+
+		const uint64_t a = v & 0x7FFFFFFFFFFFFFFF;
+		v = ( a == 0 ? 0 : v );
+		v = ( a > 0x7FF0000000000000 ? 0x7FF8000000000000 : v );
+
+		h[ i ] = kh_fold64( v, KOMIHASH_VALIDMASK( Validity, i ), h[ i ]);
+	}
+}
+
+/**
+ * @brief Function folds a column of 128-bit decimal values into per-row
+ * hash values.
+ *
+ * For each row, the resulting hash value is equal to the value returned by
+ * the komihash() function for value's 16 bytes, with the row's current hash
+ * value used as the seed. Null rows are hashed as empty messages, without
+ * branching.
+ *
+ * @param Col Column's values, 16 bytes per value, in little-endian order
+ * (the "Apache Arrow" decimal128 layout).
+ * @param Rows The number of rows.
+ * @param Validity Validity bitmap, or 0 if all rows are valid.
+ * @param[in,out] h Per-row hash values, `Rows` elements.
+ */
+
+static inline void komihash_column_fold_d128( const uint8_t* const Col,
+	const size_t Rows, const uint8_t* const Validity, uint64_t* const h )
+{
+	size_t i;
+
+	if( Validity == 0 )
+	{
+		for( i = 0; i < Rows; i++ )
+		{
+			h[ i ] = kh_fold128( kh_lu64ec( Col + i * 16 ),
+				kh_lu64ec( Col + i * 16 + 8 ), ~(uint64_t) 0, h[ i ]);
+		}
+
+		return;
+	}
+
+	for( i = 0; i < Rows; i++ )
+	{
+		h[ i ] = kh_fold128( kh_lu64ec( Col + i * 16 ),
+			kh_lu64ec( Col + i * 16 + 8 ), KOMIHASH_VALIDMASK( Validity, i ),
+			h[ i ]);
+	}
+}
+
+/**
+ * @brief KOMIRAND 64-bit pseudo-random number generator.
+ *
+ * Simple, reliable, self-starting yet efficient PRNG, with 2^64 period.
+ * 0.62 cycles/byte performance. Self-starts in 4 iterations, which is a
+ * suggested "warming up" initialization before using its output.
+ *
+ * @param[in,out] Seed1 Seed value 1. Can be initialized to any value
+ * (even 0). This is the usual "PRNG seed" value.
+ * @param[in,out] Seed2 Seed value 2, a supporting variable. Best initialized
+ * to the same value as `Seed1`.
+ * @return The next uniformly-random 64-bit value.
+ */
+
+static KOMIHASH_INLINE uint64_t komirand( uint64_t* const Seed1,
+	uint64_t* const Seed2 )
+{
+	uint64_t s1 = *Seed1;
+	uint64_t s2 = *Seed2;
+
+	kh_m128( s1, s2, &s1, &s2 );
+	s2 += 0xAAAAAAAAAAAAAAAA;
+	s1 ^= s2;
+
+	*Seed2 = s2;
+	*Seed1 = s1;
+
+	return( s1 );
+}
+
+/**
+ * @def KOMIHASH_BUFSIZE
+ * @brief Streamed hashing's buffer size, in bytes.
+ *
+ * Must be a multiple of 64, and not less than 128. Can be defined externally.
+ */
+
+#if !defined( KOMIHASH_BUFSIZE )
+
+	#define KOMIHASH_BUFSIZE 768
+
+#endif // !defined( KOMIHASH_BUFSIZE )
+
+/**
+ * @brief Context structure for the streamed "komihash" hashing.
+ *
+ * The komihash_init() function should be called to initalize the structure
+ * before hashing. Note that the default buffer size is modest, permitting
+ * placement of this structure on stack. Before the actual hashing is
+ * started, `Seed` holds the initial hashing state, equal to that of the
+ * komihash_key_t structure.
+ */
+
+typedef struct {
+	uint8_t pb[ 8 ]; ///< Buffer's padding bytes, to avoid OOB.
+	uint8_t Buf[ KOMIHASH_BUFSIZE ]; ///< Buffer.
+	uint64_t Seed[ 8 ]; ///< Hashing state variables.
+	size_t BufFill; ///< Buffer fill count (position), in bytes.
+	size_t IsHashing; ///< 0 or 1, equals 1 if the actual hashing was started.
+} komihash_stream_t;
+
+/**
+ * @brief Function initializes the streamed "komihash" hashing session.
+ *
+ * @param[out] ctx Pointer to the context structure.
+ * @param UseSeed Optional value, to use instead of the default seed. To use
+ * the default seed, set to 0. The UseSeed value can have any bit length and
+ * statistical quality, and is used only as an additional entropy source. May
+ * need endianness-correction via KOMIHASH_EC64(), if this value is shared
+ * between big- and little-endian systems.
+ */
+
+static inline void komihash_stream_init( komihash_stream_t* const ctx,
+	const uint64_t UseSeed )
+{
+	komihash_key_t key;
+	komihash_key_init( &key, UseSeed );
+
+	memcpy( ctx -> Seed, key.Seed, sizeof( ctx -> Seed ));
+	ctx -> BufFill = 0;
+	ctx -> IsHashing = 0;
+}
+
+/**
+ * @brief Function initializes the streamed "komihash" hashing session, with
+ * a precomputed seed state.
+ *
+ * @param[out] ctx Pointer to the context structure.
+ * @param key Pointer to the seed state structure, initialized via the
+ * komihash_key_init() function.
+ */
+
+static inline void komihash_stream_init_key( komihash_stream_t* const ctx,
+	const komihash_key_t* const key )
+{
+	memcpy( ctx -> Seed, key -> Seed, sizeof( ctx -> Seed ));
+	ctx -> BufFill = 0;
+	ctx -> IsHashing = 0;
+}
+
+/**
+ * @brief Function copies bytes with ASCII lowercase conversion (for internal
+ * use).
+ *
+ * @param[out] op Destination pointer.
+ * @param ip Source pointer.
+ * @param l The number of bytes to copy.
+ */
+
+static KOMIHASH_INLINE void kh_lc_copy( uint8_t* op, const uint8_t* ip,
+	size_t l )
+{
+	while( l != 0 )
+	{
+		const uint8_t c = *ip;
+		*op = (uint8_t) ( (unsigned int) ( c - 'A' ) < 26 ? c + 32 : c );
+		ip++;
+		op++;
+		l--;
+	}
+}
+
+/**
+ * @brief Function updates the streamed hashing state with a new input data,
+ * optionally ASCII case-insensitively (for internal use).
+ *
+ * @param[in,out] ctx Pointer to the context structure.
+ * @param Msg0 The next part of the whole message being hashed.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param Ci 1 if `A-Z` bytes should be converted to `a-z`, 0 otherwise.
+ * Expected to be a constant, for branches to be eliminated.
+ */
+
+static KOMIHASH_INLINE void kh_stream_update( komihash_stream_t* const ctx,
+	const void* const Msg0, size_t MsgLen, const int Ci )
+{
+	const uint8_t* Msg = (const uint8_t*) Msg0;
+
+	const uint8_t* SwMsg = 0;
+	size_t SwMsgLen = 0;
+	size_t BufFill = ctx -> BufFill;
+
+	if( BufFill + MsgLen >= KOMIHASH_BUFSIZE && BufFill != 0 )
+	{
+		const size_t CopyLen = KOMIHASH_BUFSIZE - BufFill;
+
+		if( Ci )
+		{
+			kh_lc_copy( ctx -> Buf + BufFill, Msg, CopyLen );
+		}
+		else
+		{
+			memcpy( ctx -> Buf + BufFill, Msg, CopyLen );
+		}
+
+		BufFill = 0;
+
+		SwMsg = Msg + CopyLen;
+		SwMsgLen = MsgLen - CopyLen;
+
+		Msg = ctx -> Buf;
+		MsgLen = KOMIHASH_BUFSIZE;
+	}
+
+	if( BufFill == 0 )
+	{
+		while( MsgLen > 127 )
+		{
+			uint64_t Seed1, Seed2, Seed3, Seed4;
+			uint64_t Seed5, Seed6, Seed7, Seed8;
+
+			KOMIHASH_PREFETCH_2( Msg );
+
+			ctx -> IsHashing = 1;
+
+			Seed1 = ctx -> Seed[ 0 ];
+			Seed2 = ctx -> Seed[ 1 ];
+			Seed3 = ctx -> Seed[ 2 ];
+			Seed4 = ctx -> Seed[ 3 ];
+			Seed5 = ctx -> Seed[ 4 ];
+			Seed6 = ctx -> Seed[ 5 ];
+			Seed7 = ctx -> Seed[ 6 ];
+			Seed8 = ctx -> Seed[ 7 ];
+
+			if( Ci && Msg != ctx -> Buf )
+			{
+				// The buffer is hashed via the usual loop, as it may hold
+				// data of komihash_stream_update() calls, which should not
+				// be converted.
+
+				KOMIHASH_HASHLOOP64_L( kh_lu64ec_ci );
+			}
+			else
+			{
+				KOMIHASH_HASHLOOP64();
+			}
+
+			ctx -> Seed[ 0 ] = Seed1;
+			ctx -> Seed[ 1 ] = Seed2;
+			ctx -> Seed[ 2 ] = Seed3;
+			ctx -> Seed[ 3 ] = Seed4;
+			ctx -> Seed[ 4 ] = Seed5;
+			ctx -> Seed[ 5 ] = Seed6;
+			ctx -> Seed[ 6 ] = Seed7;
+			ctx -> Seed[ 7 ] = Seed8;
+
+			if( SwMsgLen == 0 )
+			{
+				if( MsgLen != 0 )
+				{
+					break;
+				}
+
+				ctx -> BufFill = 0;
+				return;
+			}
+
+			Msg = SwMsg;
+			MsgLen = SwMsgLen;
+			SwMsgLen = 0;
+		}
+	}
+
+	ctx -> BufFill = BufFill + MsgLen;
+	uint8_t* op = ctx -> Buf + BufFill;
+
+	if( Ci )
+	{
+		kh_lc_copy( op, Msg, MsgLen );
+		return;
+	}
+
+	while( MsgLen != 0 )
+	{
+		*op = *Msg;
+		Msg++;
+		op++;
+		MsgLen--;
+	}
+}
+
+/**
+ * @brief Function updates the streamed hashing state with a new input data.
+ *
+ * @param[in,out] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_stream_init() function.
+ * @param Msg0 The next part of the whole message being hashed. The alignment
+ * of this pointer is unimportant. It is valid to pass 0 when `MsgLen` equals
+ * 0.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ */
+
+static inline void komihash_stream_update( komihash_stream_t* const ctx,
+	const void* const Msg0, const size_t MsgLen )
+{
+	kh_stream_update( ctx, Msg0, MsgLen, 0 );
+}
+
+/**
+ * @brief Function updates the streamed hashing state with a small
+ * fixed-size input data (for internal use).
+ *
+ * The data is stored directly into the buffer, if it fits; otherwise, the
+ * komihash_stream_update() function is called.
+ *
+ * @param[in,out] ctx Pointer to the context structure.
+ * @param Msg Data pointer.
+ * @param MsgLen Data's length, in bytes; expected to be a compile-time
+ * constant, for the `memcpy()` call to be reduced to a single store.
+ */
+
+static KOMIHASH_INLINE void kh_stream_update_n( komihash_stream_t* const ctx,
+	const void* const Msg, const size_t MsgLen )
+{
+	const size_t BufFill = ctx -> BufFill;
+
+	if( KOMIHASH_LIKELY( BufFill + MsgLen < KOMIHASH_BUFSIZE ))
+	{
+		memcpy( ctx -> Buf + BufFill, Msg, MsgLen );
+		ctx -> BufFill = BufFill + MsgLen;
+	}
+	else
+	{
+		komihash_stream_update( ctx, Msg, MsgLen );
+	}
+}
+
+/**
+ * @brief Function updates the streamed hashing state with an 8-bit value.
+ *
+ * Equivalent to the komihash_stream_update() function called for the
+ * value's byte, but is considerably faster when many small values are
+ * hashed.
+ *
+ * @param[in,out] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_stream_init() function.
+ * @param v Value to hash.
+ */
+
+static inline void komihash_stream_update_u8( komihash_stream_t* const ctx,
+	const uint8_t v )
+{
+	kh_stream_update_n( ctx, &v, 1 );
+}
+
+/**
+ * @brief Function updates the streamed hashing state with a 16-bit value.
+ *
+ * Equivalent to the komihash_stream_update() function called for the
+ * value's 2-byte little-endian representation, but is considerably faster
+ * when many small values are hashed.
+ *
+ * @param[in,out] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_stream_init() function.
+ * @param v Value to hash.
+ */
+
+static inline void komihash_stream_update_u16( komihash_stream_t* const ctx,
+	const uint16_t v )
+{
+	const uint8_t b[ 2 ] = { (uint8_t) v, (uint8_t) ( v >> 8 )};
+
+	kh_stream_update_n( ctx, b, 2 );
+}
+
+/**
+ * @brief Function updates the streamed hashing state with a 32-bit value.
+ *
+ * Equivalent to the komihash_stream_update() function called for the
+ * value's 4-byte little-endian representation, but is considerably faster
+ * when many small values are hashed.
+ *
+ * @param[in,out] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_stream_init() function.
+ * @param v Value to hash.
+ */
+
+static inline void komihash_stream_update_u32( komihash_stream_t* const ctx,
+	const uint32_t v )
+{
+	const uint32_t ev = KOMIHASH_EC32( v );
+
+	kh_stream_update_n( ctx, &ev, 4 );
+}
+
+/**
+ * @brief Function updates the streamed hashing state with a 64-bit value.
+ *
+ * Equivalent to the komihash_stream_update() function called for the
+ * value's 8-byte little-endian representation, but is considerably faster
+ * when many small values are hashed.
+ *
+ * @param[in,out] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_stream_init() function.
+ * @param v Value to hash.
+ */
+
+static inline void komihash_stream_update_u64( komihash_stream_t* const ctx,
+	const uint64_t v )
+{
+	const uint64_t ev = KOMIHASH_EC64( v );
+
+	kh_stream_update_n( ctx, &ev, 8 );
+}
+
+#if defined( __cplusplus )
+
+/**
+ * @brief Function updates the streamed hashing state with a fixed-size
+ * input data (C++ only).
+ *
+ * Equivalent to the komihash_stream_update() function, but the data's
+ * length is a compile-time constant, and the data is stored directly into
+ * the buffer if it fits. Intended for small fields (e.g., structure members
+ * or fixed-size keys).
+ *
+ * @tparam N Data's length, in bytes.
+ * @param[in,out] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_stream_init() function.
+ * @param Msg Data pointer, the alignment is unimportant.
+ */
+
+template< size_t N >
+static inline void komihash_stream_update_n( komihash_stream_t* const ctx,
+	const void* const Msg )
+{
+	kh_stream_update_n( ctx, Msg, N );
+}
+
+#endif // defined( __cplusplus )
+
+/**
+ * @brief Function updates the states of several streamed hashing sessions
+ * with a new input data (multi-buffer update).
+ *
+ * Equivalent to calling the komihash_stream_update() function for each
+ * context, but advances the 64-byte hashing loops of context pairs
+ * together, so that the multiplier is kept busy by 8 independent lanes. The
+ * interleaving is used if both contexts of a pair have an empty buffer, and
+ * both new inputs are longer than 127 bytes.
+ *
+ * @param ctxs Pointers to context structures, each structure must be
+ * initialized via the komihash_stream_init() function. Pointers should be
+ * unique.
+ * @param Msgs Pointers to the next parts of the messages being hashed.
+ * @param MsgLens Lengths of the next parts of the messages, in bytes, can be
+ * zero.
+ * @param n The number of contexts to update.
+ */
+
+static inline void komihash_stream_update_mb( komihash_stream_t* const* const
+	ctxs, const void* const* const Msgs, const size_t* const MsgLens,
+	const size_t n )
+{
+	size_t i;
+
+	for( i = 0; i + 1 < n; i += 2 )
+	{
+		komihash_stream_t* const ca = ctxs[ i ];
+		komihash_stream_t* const cb = ctxs[ i + 1 ];
+		const uint8_t* ma = (const uint8_t*) Msgs[ i ];
+		const uint8_t* mb = (const uint8_t*) Msgs[ i + 1 ];
+		size_t la = MsgLens[ i ];
+		size_t lb = MsgLens[ i + 1 ];
+
+		if( ca -> BufFill == 0 && cb -> BufFill == 0 && la > 127 &&
+			lb > 127 )
+		{
+			uint64_t a[ 8 ], b[ 8 ];
+
+			memcpy( a, ca -> Seed, sizeof( a ));
+			memcpy( b, cb -> Seed, sizeof( b ));
+
+			do
+			{
+				KOMIHASH_PREFETCH_1( ma );
+				KOMIHASH_PREFETCH_1( mb );
+
+				KOMIHASH_HASH64( ma, a[ 0 ], a[ 1 ], a[ 2 ], a[ 3 ],
+					a[ 4 ], a[ 5 ], a[ 6 ], a[ 7 ]);
+
+				KOMIHASH_HASH64( mb, b[ 0 ], b[ 1 ], b[ 2 ], b[ 3 ],
+					b[ 4 ], b[ 5 ], b[ 6 ], b[ 7 ]);
+
+				ma += 64;
+				la -= 64;
+				mb += 64;
+				lb -= 64;
+
+				KOMIHASH_PREFETCH_2( ma );
+				KOMIHASH_PREFETCH_2( mb );
+
+			} while( KOMIHASH_LIKELY( la > 63 && lb > 63 ));
+
+			memcpy( ca -> Seed, a, sizeof( a ));
+			memcpy( cb -> Seed, b, sizeof( b ));
+			ca -> IsHashing = 1;
+			cb -> IsHashing = 1;
+		}
+
+		komihash_stream_update( ca, ma, la );
+		komihash_stream_update( cb, mb, lb );
+	}
+
+	if( i < n )
+	{
+		komihash_stream_update( ctxs[ i ], Msgs[ i ], MsgLens[ i ]);
+	}
+}
+
+/**
+ * @brief Function finalizes the streamed "komihash" hashing session, with an
+ * optional upper half of the 128-bit hash value (for internal use).
+ *
+ * @param[in] ctx Pointer to the context structure.
+ * @param[out] Hash2 Pointer to the upper half of the 128-bit hash value, or
+ * 0 if not needed.
+ * @return 64-bit hash value (the lower half of the 128-bit hash value).
+ */
+
+static KOMIHASH_INLINE uint64_t kh_stream_final2(
+	komihash_stream_t* const ctx, uint64_t* const Hash2 )
+{
+	const uint8_t* Msg = ctx -> Buf;
+	size_t MsgLen = ctx -> BufFill;
+
+	if( ctx -> IsHashing == 0 )
+	{
+		return( komihash_body2( Msg, MsgLen, ctx -> Seed[ 0 ],
+			ctx -> Seed[ 4 ], Hash2 ));
+	}
+
+	ctx -> pb[ 4 ] = 0;
+	ctx -> pb[ 5 ] = 0;
+	ctx -> pb[ 6 ] = 0;
+	ctx -> pb[ 7 ] = 0;
+
+	uint64_t Seed1 = ctx -> Seed[ 0 ];
+	uint64_t Seed2 = ctx -> Seed[ 1 ];
+	uint64_t Seed3 = ctx -> Seed[ 2 ];
+	uint64_t Seed4 = ctx -> Seed[ 3 ];
+	uint64_t Seed5 = ctx -> Seed[ 4 ];
+	uint64_t Seed6 = ctx -> Seed[ 5 ];
+	uint64_t Seed7 = ctx -> Seed[ 6 ];
+	uint64_t Seed8 = ctx -> Seed[ 7 ];
+
+	if( MsgLen > 63 )
+	{
+		KOMIHASH_HASHLOOP64();
+	}
+
+	Seed5 ^= Seed6 ^ Seed7 ^ Seed8;
+	Seed1 ^= Seed2 ^ Seed3 ^ Seed4;
+
+	return( komihash_epi2( Msg, MsgLen, Seed1, Seed5, Hash2 ));
+}
+
+/**
+ * @brief Function finalizes the streamed "komihash" hashing session.
+ * 
+ * Returns the resulting hash value of the previously hashed data. This value
+ * is equal to the value returned by the komihash() function for the same
+ * provided data.
+ *
+ * Note that since this function is non-destructive to the context structure,
+ * the function can be used to obtain intermediate hashes of the data stream
+ * being hashed, and the hashing can then be resumed.
+ *
+ * @param[in] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_stream_init() function.
+ * @return 64-bit hash value. Should be endianness-corrected when this value
+ * is shared between big- and little-endian systems.
+ */
+
+static inline uint64_t komihash_stream_final( komihash_stream_t* const ctx )
+{
+	return( kh_stream_final2( ctx, 0 ));
+}
+
+/**
+ * @brief Function finalizes the streamed "komihash" hashing session,
+ * producing a 128-bit hash value.
+ *
+ * The resulting hash value is equal to the value produced by the
+ * komihash128() function for the same provided data. Like the
+ * komihash_stream_final() function, this function is non-destructive to the
+ * context structure.
+ *
+ * @param[in] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_stream_init() function.
+ * @param[out] Hash Resulting 128-bit hash value: `Hash[ 0 ]` receives the
+ * lower half, `Hash[ 1 ]` receives the upper half.
+ */
+
+static inline void komihash_stream_final128( komihash_stream_t* const ctx,
+	uint64_t* const Hash )
+{
+	Hash[ 0 ] = kh_stream_final2( ctx, Hash + 1 );
+}
+
+/**
+ * @def KOMIHASH_SAVE_VER
+ * @brief The version of the komihash_stream_save() function's blob format.
+ *
+ * The blob consists of: the "KHS" signature and the version byte; eight
+ * little-endian 64-bit `Seed` values; the `IsHashing` byte; the 32-bit
+ * little-endian buffer fill count; the filled part of the buffer.
+ */
+
+#define KOMIHASH_SAVE_VER 1
+
+/**
+ * @def KOMIHASH_SAVE_MAXLEN
+ * @brief The maximal length of the komihash_stream_save() function's blob,
+ * in bytes.
+ */
+
+#define KOMIHASH_SAVE_MAXLEN ( 4 + 64 + 1 + 4 + KOMIHASH_BUFSIZE )
+
+/**
+ * @brief Function saves the streamed hashing state into a portable blob.
+ *
+ * The blob is endianness-neutral, and does not depend on the
+ * KOMIHASH_BUFSIZE value: the hashing can be resumed from the blob via the
+ * komihash_stream_load() function on any system (e.g., after a process
+ * restart during a long upload).
+ *
+ * @param[in] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_stream_init() function.
+ * @param[out] Blob Output blob, with a capacity of at least
+ * KOMIHASH_SAVE_MAXLEN bytes.
+ * @return The length of the written blob, in bytes.
+ */
+
+static inline size_t komihash_stream_save( const komihash_stream_t* const ctx,
+	uint8_t* const Blob )
+{
+	const size_t BufFill = ctx -> BufFill;
+	int i;
+
+	Blob[ 0 ] = 'K';
+	Blob[ 1 ] = 'H';
+	Blob[ 2 ] = 'S';
+	Blob[ 3 ] = KOMIHASH_SAVE_VER;
+
+	for( i = 0; i < 64; i++ )
+	{
+		Blob[ 4 + i ] = (uint8_t) ( ctx -> Seed[ i >> 3 ] >> ( i & 7 ) * 8 );
+	}
+
+	Blob[ 68 ] = (uint8_t) ( ctx -> IsHashing != 0 );
+
+	for( i = 0; i < 4; i++ )
+	{
+		Blob[ 69 + i ] = (uint8_t) ( BufFill >> i * 8 );
+	}
+
+	memcpy( Blob + 73, ctx -> Buf, BufFill );
+
+	return( 73 + BufFill );
+}
+
+/**
+ * @brief Function restores the streamed hashing state from a blob produced
+ * by the komihash_stream_save() function.
+ *
+ * After a successful restore, the hashing can be continued with the
+ * komihash_stream_update() function, and finalized with the
+ * komihash_stream_final() function, producing the same hash value as the
+ * uninterrupted hashing session.
+ *
+ * @param[out] ctx Pointer to the context structure; does not need to be
+ * initialized.
+ * @param Blob Input blob.
+ * @param BlobLen Blob's length, in bytes.
+ * @return 1 if the state was restored, 0 if the blob is malformed, or was
+ * produced by an unsupported blob format version (`ctx` is left
+ * uninitialized).
+ */
+
+static inline int komihash_stream_load( komihash_stream_t* const ctx,
+	const uint8_t* const Blob, const size_t BlobLen )
+{
+	if( BlobLen < 73 || Blob[ 0 ] != 'K' || Blob[ 1 ] != 'H' ||
+		Blob[ 2 ] != 'S' || Blob[ 3 ] != KOMIHASH_SAVE_VER || Blob[ 68 ] > 1 )
+	{
+		return( 0 );
+	}
+
+	const size_t BufFill = (size_t) Blob[ 69 ] | (size_t) Blob[ 70 ] << 8 |
+		(size_t) Blob[ 71 ] << 16 | (size_t) Blob[ 72 ] << 24;
+
+	if( BufFill != BlobLen - 73 )
+	{
+		return( 0 );
+	}
+
+	int i;
+
+	for( i = 0; i < 8; i++ )
+	{
+		ctx -> Seed[ i ] = kh_lu64ec( Blob + 4 + i * 8 );
+	}
+
+	ctx -> IsHashing = Blob[ 68 ];
+	ctx -> BufFill = 0;
+
+	// The buffered data is passed to the update function, which hashes its
+	// full 64-byte blocks if needed (which does not change the resulting
+	// hash value); this makes the blob independent of KOMIHASH_BUFSIZE.
+
+	komihash_stream_update( ctx, Blob + 73, BufFill );
+
+	return( 1 );
+}
+
+/**
+ * @brief FOR TESTING PURPOSES ONLY - use the komihash() function instead.
+ *
+ * @param Msg The message to produce a hash from.
+ * @param MsgLen Message's length, in bytes.
+ * @param UseSeed Seed to use.
+ * @return 64-bit hash value.
+ */
+
+static inline uint64_t komihash_stream_oneshot( const void* const Msg,
+	const size_t MsgLen, const uint64_t UseSeed )
+{
+	komihash_stream_t ctx;
+
+	komihash_stream_init( &ctx, UseSeed );
+	komihash_stream_update( &ctx, Msg, MsgLen );
+
+	return( komihash_stream_final( &ctx ));
+}
+
+/**
+ * @brief Context structure for the compact streamed "komihash" hashing.
+ *
+ * An alternative to the komihash_stream_t structure, for uses where a large
+ * number of contexts exist at the same time. Full 64-byte blocks are hashed
+ * directly from the input data, only the remaining part (less than 64 bytes)
+ * is buffered. The komihash_cstream_init() function should be called to
+ * initalize the structure before hashing.
+ */
+
+typedef struct {
+	uint64_t Seed[ 8 ]; ///< Hashing state variables.
+	uint8_t pb[ 8 ]; ///< Buffer's padding bytes, to avoid OOB.
+	uint8_t Buf[ 64 ]; ///< Buffer of the remaining part.
+	size_t BufFill; ///< Buffer fill count (position), in bytes.
+	size_t IsHashing; ///< 0 or 1, equals 1 if the actual hashing was started.
+} komihash_cstream_t;
+
+/**
+ * @brief Function initializes the compact streamed "komihash" hashing
+ * session.
+ *
+ * @param[out] ctx Pointer to the context structure.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash_stream_init() function.
+ */
+
+static inline void komihash_cstream_init( komihash_cstream_t* const ctx,
+	const uint64_t UseSeed )
+{
+	komihash_key_t key;
+	komihash_key_init( &key, UseSeed );
+
+	memcpy( ctx -> Seed, key.Seed, sizeof( ctx -> Seed ));
+	memset( ctx -> pb, 0, sizeof( ctx -> pb ));
+	ctx -> BufFill = 0;
+	ctx -> IsHashing = 0;
+}
+
+/**
+ * @brief Function updates the compact streamed hashing state with a new
+ * input data.
+ *
+ * @param[in,out] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_cstream_init() function.
+ * @param Msg0 The next part of the whole message being hashed. The alignment
+ * of this pointer is unimportant. It is valid to pass 0 when `MsgLen` equals
+ * 0.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ */
+
+static inline void komihash_cstream_update( komihash_cstream_t* const ctx,
+	const void* const Msg0, size_t MsgLen )
+{
+	const uint8_t* Msg = (const uint8_t*) Msg0;
+	size_t BufFill = ctx -> BufFill;
+
+	if( BufFill + MsgLen < 64 )
+	{
+		if( MsgLen != 0 )
+		{
+			memcpy( ctx -> Buf + BufFill, Msg, MsgLen );
+			ctx -> BufFill = BufFill + MsgLen;
+		}
+
+		return;
+	}
+
+	// Since the whole message is at least 64 bytes long, all its full 64-byte
+	// blocks are hashed by the komihash() function's loop.
+
+	uint64_t Seed1 = ctx -> Seed[ 0 ];
+	uint64_t Seed2 = ctx -> Seed[ 1 ];
+	uint64_t Seed3 = ctx -> Seed[ 2 ];
+	uint64_t Seed4 = ctx -> Seed[ 3 ];
+	uint64_t Seed5 = ctx -> Seed[ 4 ];
+	uint64_t Seed6 = ctx -> Seed[ 5 ];
+	uint64_t Seed7 = ctx -> Seed[ 6 ];
+	uint64_t Seed8 = ctx -> Seed[ 7 ];
+
+	if( BufFill != 0 )
+	{
+		const size_t CopyLen = 64 - BufFill;
+		memcpy( ctx -> Buf + BufFill, Msg, CopyLen );
+
+		Msg += CopyLen;
+		MsgLen -= CopyLen;
+
+		KOMIHASH_HASH64( ctx -> Buf, Seed1, Seed2, Seed3, Seed4,
+			Seed5, Seed6, Seed7, Seed8 );
+	}
+
+	if( MsgLen > 63 )
+	{
+		KOMIHASH_HASHLOOP64();
+	}
+
+	ctx -> Seed[ 0 ] = Seed1;
+	ctx -> Seed[ 1 ] = Seed2;
+	ctx -> Seed[ 2 ] = Seed3;
+	ctx -> Seed[ 3 ] = Seed4;
+	ctx -> Seed[ 4 ] = Seed5;
+	ctx -> Seed[ 5 ] = Seed6;
+	ctx -> Seed[ 6 ] = Seed7;
+	ctx -> Seed[ 7 ] = Seed8;
+	ctx -> IsHashing = 1;
+
+	memcpy( ctx -> Buf, Msg, MsgLen );
+	ctx -> BufFill = MsgLen;
+}
+
+/**
+ * @brief Function finalizes the compact streamed "komihash" hashing session.
+ *
+ * Returns the resulting hash value of the previously hashed data. This value
+ * is equal to the value returned by the komihash() function for the same
+ * provided data. This function is non-destructive to the context structure.
+ *
+ * @param[in] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_cstream_init() function.
+ * @return 64-bit hash value.
+ */
+
+static inline uint64_t komihash_cstream_final(
+	const komihash_cstream_t* const ctx )
+{
+	const uint8_t* const Msg = ctx -> Buf;
+	const size_t MsgLen = ctx -> BufFill;
+
+	if( ctx -> IsHashing == 0 )
+	{
+		return( komihash_body( Msg, MsgLen, ctx -> Seed[ 0 ],
+			ctx -> Seed[ 4 ]));
+	}
+
+	const uint64_t Seed5 = ctx -> Seed[ 4 ] ^ ctx -> Seed[ 5 ] ^
+		ctx -> Seed[ 6 ] ^ ctx -> Seed[ 7 ];
+
+	const uint64_t Seed1 = ctx -> Seed[ 0 ] ^ ctx -> Seed[ 1 ] ^
+		ctx -> Seed[ 2 ] ^ ctx -> Seed[ 3 ];
+
+	return( komihash_epi( Msg, MsgLen, Seed1, Seed5 ));
+}
+
+/**
+ * @brief Prefix state structure, for hashing many messages that share a
+ * common prefix.
+ *
+ * Equal to the komihash_cstream_t structure: the hashing state after the
+ * prefix's full 64-byte blocks were absorbed, and the remaining part of the
+ * prefix (less than 64 bytes). The prefix can be extended via the
+ * komihash_cstream_update() function.
+ */
+
+typedef komihash_cstream_t komihash_prefix_t;
+
+/**
+ * @brief Function initializes the prefix state structure.
+ *
+ * @param[out] ps Pointer to the prefix state structure.
+ * @param Prefix The common prefix. The alignment of this pointer is
+ * unimportant. It is valid to pass 0 when `PrefixLen` equals 0.
+ * @param PrefixLen Prefix's length, in bytes, can be zero.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ */
+
+static inline void komihash_prefix_init( komihash_prefix_t* const ps,
+	const void* const Prefix, const size_t PrefixLen,
+	const uint64_t UseSeed )
+{
+	komihash_cstream_init( ps, UseSeed );
+	komihash_cstream_update( ps, Prefix, PrefixLen );
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for a message with a known prefix.
+ *
+ * Returns a value equal to the value returned by the komihash() function for
+ * the concatenation of the prefix and the suffix. Only the suffix is hashed:
+ * the prefix state structure is not copied nor modified, and can be used
+ * for any number of suffixes.
+ *
+ * @param ps Pointer to the prefix state structure, initialized via the
+ * komihash_prefix_init() or komihash_cstream_init() function.
+ * @param Suffix0 The suffix. The alignment of this pointer is unimportant.
+ * It is valid to pass 0 when `SuffixLen` equals 0.
+ * @param SuffixLen Suffix's length, in bytes, can be zero.
+ * @return 64-bit hash value.
+ */
+
+static inline uint64_t komihash_from_prefix( const komihash_prefix_t* const ps,
+	const void* const Suffix0, size_t SuffixLen )
+{
+	const uint8_t* Msg = (const uint8_t*) Suffix0;
+	const size_t BufFill = ps -> BufFill;
+
+	// The last part of the message (less than 64 bytes) is hashed from a
+	// local buffer, with 8 padding bytes permitting the `Msg[ -8 ]` reads.
+
+	uint8_t lb[ 8 + 64 ];
+	uint8_t* const lm = lb + 8;
+
+	memset( lb, 0, 8 );
+
+	if( BufFill + SuffixLen < 64 )
+	{
+		memcpy( lm, ps -> Buf, BufFill );
+
+		if( SuffixLen != 0 )
+		{
+			memcpy( lm + BufFill, Msg, SuffixLen );
+		}
+
+		if( ps -> IsHashing == 0 )
+		{
+			return( komihash_body( lm, BufFill + SuffixLen, ps -> Seed[ 0 ],
+				ps -> Seed[ 4 ]));
+		}
+
+		const uint64_t Seed5 = ps -> Seed[ 4 ] ^ ps -> Seed[ 5 ] ^
+			ps -> Seed[ 6 ] ^ ps -> Seed[ 7 ];
+
+		const uint64_t Seed1 = ps -> Seed[ 0 ] ^ ps -> Seed[ 1 ] ^
+			ps -> Seed[ 2 ] ^ ps -> Seed[ 3 ];
+
+		return( komihash_epi( lm, BufFill + SuffixLen, Seed1, Seed5 ));
+	}
+
+	// Since the whole message is at least 64 bytes long, the 64-byte hashing
+	// loop is used.
+
+	uint64_t Seed1 = ps -> Seed[ 0 ];
+	uint64_t Seed2 = ps -> Seed[ 1 ];
+	uint64_t Seed3 = ps -> Seed[ 2 ];
+	uint64_t Seed4 = ps -> Seed[ 3 ];
+	uint64_t Seed5 = ps -> Seed[ 4 ];
+	uint64_t Seed6 = ps -> Seed[ 5 ];
+	uint64_t Seed7 = ps -> Seed[ 6 ];
+	uint64_t Seed8 = ps -> Seed[ 7 ];
+
+	if( BufFill != 0 )
+	{
+		const size_t CopyLen = 64 - BufFill;
+
+		memcpy( lm, ps -> Buf, BufFill );
+		memcpy( lm + BufFill, Msg, CopyLen );
+
+		Msg += CopyLen;
+		SuffixLen -= CopyLen;
+
+		KOMIHASH_HASH64( lm, Seed1, Seed2, Seed3, Seed4,
+			Seed5, Seed6, Seed7, Seed8 );
+	}
+
+	if( SuffixLen > 63 )
+	{
+		size_t MsgLen = SuffixLen;
+
+		KOMIHASH_HASHLOOP64();
+
+		SuffixLen = MsgLen;
+	}
+
+	if( SuffixLen != 0 )
+	{
+		memcpy( lm, Msg, SuffixLen );
+	}
+
+	Seed5 ^= Seed6 ^ Seed7 ^ Seed8;
+	Seed1 ^= Seed2 ^ Seed3 ^ Seed4;
+
+	return( komihash_epi( lm, SuffixLen, Seed1, Seed5 ));
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, for several prefixes of a message.
+ *
+ * Produces hash values of message's prefixes ending at the specified cut
+ * points (e.g., at each `/` of a path), each equal to the value returned by
+ * the komihash() function for the respective prefix. The 64-byte hashing
+ * loop is run over the message once, and each prefix's hash is produced by
+ * a non-destructive finalization of the current hashing state, making the
+ * cost linear in message's length, instead of quadratic.
+ *
+ * @param Msg0 The message. The alignment of this pointer is unimportant.
+ * @param MsgLen0 Message's length, in bytes, can be zero.
+ * @param CutPoints Prefix lengths, in bytes; values above `MsgLen0` are
+ * treated as equal to `MsgLen0`. Should be sorted in ascending order, for
+ * maximal performance (unsorted cut points are supported, but may require a
+ * full hashing of a prefix).
+ * @param n The number of cut points.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ * @param[out] out Resulting hash values, `n` elements.
+ */
+
+static inline void komihash_prefixes( const void* const Msg0,
+	const size_t MsgLen0, const size_t* const CutPoints, const size_t n,
+	const uint64_t UseSeed, uint64_t* const out )
+{
+	const uint8_t* const MsgStart = (const uint8_t*) Msg0;
+
+	KOMIHASH_SEEDINIT();
+
+	const uint64_t InitSeed1 = Seed1;
+	const uint64_t InitSeed5 = Seed5;
+
+	uint64_t Seed2 = 0x13198A2E03707344 ^ Seed1;
+	uint64_t Seed3 = 0xA4093822299F31D0 ^ Seed1;
+	uint64_t Seed4 = 0x082EFA98EC4E6C89 ^ Seed1;
+	uint64_t Seed6 = 0xBE5466CF34E90C6C ^ Seed5;
+	uint64_t Seed7 = 0xC0AC29B7C97C50DD ^ Seed5;
+	uint64_t Seed8 = 0x3F84D5B5B5470917 ^ Seed5;
+
+	size_t Done = 0; // The number of bytes hashed by the 64-byte loop.
+	size_t i;
+
+	KOMIHASH_PREFETCH( MsgStart );
+
+	for( i = 0; i < n; i++ )
+	{
+		const size_t c = ( CutPoints[ i ] < MsgLen0 ? CutPoints[ i ] :
+			MsgLen0 );
+
+		if( c < 64 )
+		{
+			out[ i ] = komihash_body( MsgStart, c, InitSeed1, InitSeed5 );
+			continue;
+		}
+
+		const size_t BlocksEnd = c & ~(size_t) 63;
+
+		if( KOMIHASH_UNLIKELY( BlocksEnd < Done ))
+		{
+			out[ i ] = komihash( MsgStart, c, UseSeed );
+			continue;
+		}
+
+		if( BlocksEnd > Done )
+		{
+			const uint8_t* Msg = MsgStart + Done;
+			size_t MsgLen = BlocksEnd - Done;
+
+			KOMIHASH_HASHLOOP64();
+
+			Done = BlocksEnd;
+		}
+
+		out[ i ] = komihash_epi( MsgStart + Done, c - Done,
+			Seed1 ^ Seed2 ^ Seed3 ^ Seed4, Seed5 ^ Seed6 ^ Seed7 ^ Seed8 );
+	}
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, ASCII case-insensitive.
+ *
+ * Produces a hash value equal to the value returned by the komihash()
+ * function for the message with its `A-Z` bytes converted to `a-z` (other
+ * bytes, including UTF-8 sequences, are hashed unchanged). The conversion is
+ * performed on 64-bit words as they are loaded, so no lowercase copy of the
+ * message is needed. Designed for HTTP header name and DNS name lookups.
+ *
+ * @param Msg0 The message to produce a hash from. The alignment of this
+ * pointer is unimportant.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ * @return 64-bit hash of the lowercase-converted input data.
+ */
+
+static inline uint64_t komihash_ci( const void* const Msg0,
+	const size_t MsgLen, const uint64_t UseSeed )
+{
+	const uint8_t* const Msg = (const uint8_t*) Msg0;
+
+	KOMIHASH_SEEDINIT();
+	KOMIHASH_PREFETCH( Msg );
+
+	return( kh_body( Msg, MsgLen, Seed1, Seed5, 0, 1 ));
+}
+
+/**
+ * @brief Function updates the streamed hashing state with a new input data,
+ * ASCII case-insensitively.
+ *
+ * Equivalent to the komihash_stream_update() function called with the
+ * lowercase-converted data (see the komihash_ci() function). Since the
+ * context structure then holds only the converted data, the hashing session
+ * is finalized via the usual komihash_stream_final() function, and calls of
+ * both update functions can be mixed, e.g., to hash a case-insensitive host
+ * name followed by a case-sensitive path.
+ *
+ * @param[in,out] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_stream_init() function.
+ * @param Msg0 The next part of the whole message being hashed. The alignment
+ * of this pointer is unimportant. It is valid to pass 0 when `MsgLen` equals
+ * 0.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ */
+
+static inline void komihash_stream_update_ci( komihash_stream_t* const ctx,
+	const void* const Msg0, const size_t MsgLen )
+{
+	kh_stream_update( ctx, Msg0, MsgLen, 1 );
+}
+
+/**
+ * @def KOMIHASH_WIDEINIT()
+ * @brief Macro for the `Seed2-16` initialization of the "wide" variant, from
+ * the `Seed1` and `Seed5` values.
+ *
+ * `Seed2-8` are initialized like in the komihash() function, `Seed9-16` use
+ * the subsequent mantissa bits of PI.
+ */
+
+#define KOMIHASH_WIDEINIT() \
+	uint64_t Seed2 = 0x13198A2E03707344 ^ Seed1; \
+	uint64_t Seed3 = 0xA4093822299F31D0 ^ Seed1; \
+	uint64_t Seed4 = 0x082EFA98EC4E6C89 ^ Seed1; \
+	uint64_t Seed6 = 0xBE5466CF34E90C6C ^ Seed5; \
+	uint64_t Seed7 = 0xC0AC29B7C97C50DD ^ Seed5; \
+	uint64_t Seed8 = 0x3F84D5B5B5470917 ^ Seed5; \
+	uint64_t Seed9 = 0x9216D5D98979FB1B ^ Seed1; \
+	uint64_t Seed10 = 0xD1310BA698DFB5AC ^ Seed1; \
+	uint64_t Seed11 = 0x2FFD72DBD01ADFB7 ^ Seed1; \
+	uint64_t Seed12 = 0xB8E1AFED6A267E96 ^ Seed1; \
+	uint64_t Seed13 = 0xBA7C9045F12C7F99 ^ Seed5; \
+	uint64_t Seed14 = 0x24A19947B3916CF7 ^ Seed5; \
+	uint64_t Seed15 = 0x0801F2E2858EFC16 ^ Seed5; \
+	uint64_t Seed16 = 0x636920D871574E69 ^ Seed5;
+
+/**
+ * @def KOMIHASH_HASH128( m )
+ * @brief Macro for a hashing round of the "wide" variant, with 128-byte
+ * input.
+ *
+ * Eight 128-bit multiplications are performed, with `Seed1-4` and `Seed9-12`
+ * receiving the lower halves, and `Seed5-8` and `Seed13-16` receiving the
+ * higher halves. The "shifting" arrangement of XORs is the same as in the
+ * KOMIHASH_HASH64() macro, but spans all eight lanes.
+ *
+ * @param m Message pointer, alignment is unimportant.
+ */
+
+#define KOMIHASH_HASH128( m ) \
+	kh_m128( Seed1 ^ kh_lu64ec( m ), Seed5 ^ kh_lu64ec( m + 64 ), \
+		&Seed1, &Seed5 ); \
+	kh_m128( Seed2 ^ kh_lu64ec( m + 8 ), Seed6 ^ kh_lu64ec( m + 72 ), \
+		&Seed2, &Seed6 ); \
+	kh_m128( Seed3 ^ kh_lu64ec( m + 16 ), Seed7 ^ kh_lu64ec( m + 80 ), \
+		&Seed3, &Seed7 ); \
+	kh_m128( Seed4 ^ kh_lu64ec( m + 24 ), Seed8 ^ kh_lu64ec( m + 88 ), \
+		&Seed4, &Seed8 ); \
+	kh_m128( Seed9 ^ kh_lu64ec( m + 32 ), Seed13 ^ kh_lu64ec( m + 96 ), \
+		&Seed9, &Seed13 ); \
+	kh_m128( Seed10 ^ kh_lu64ec( m + 40 ), Seed14 ^ kh_lu64ec( m + 104 ), \
+		&Seed10, &Seed14 ); \
+	kh_m128( Seed11 ^ kh_lu64ec( m + 48 ), Seed15 ^ kh_lu64ec( m + 112 ), \
+		&Seed11, &Seed15 ); \
+	kh_m128( Seed12 ^ kh_lu64ec( m + 56 ), Seed16 ^ kh_lu64ec( m + 120 ), \
+		&Seed12, &Seed16 ); \
+	Seed2 ^= Seed5; \
+	Seed3 ^= Seed6; \
+	Seed4 ^= Seed7; \
+	Seed9 ^= Seed8; \
+	Seed10 ^= Seed13; \
+	Seed11 ^= Seed14; \
+	Seed12 ^= Seed15; \
+	Seed1 ^= Seed16;
+
+/**
+ * @def KOMIHASH_HASHLOOP128()
+ * @brief Macro for the 128-byte hashing loop of the "wide" variant.
+ *
+ * Expects `Msg` and `MsgLen` values (greater than 127), requires initialized
+ * `Seed1-16` values.
+ */
+
+#define KOMIHASH_HASHLOOP128() \
+	do \
+	{ \
+		KOMIHASH_PREFETCH_1( Msg ); \
+		KOMIHASH_PREFETCH_1( Msg + 64 ); \
+	\
+		KOMIHASH_HASH128( Msg ); \
+	\
+		Msg += 128; \
+		MsgLen -= 128; \
+	\
+		KOMIHASH_PREFETCH_2( Msg ); \
+		KOMIHASH_PREFETCH_2( Msg + 64 ); \
+	\
+	} while( KOMIHASH_LIKELY( MsgLen > 127 ));
+
+/**
+ * @def KOMIHASH_WIDEFOLD()
+ * @brief Macro folds `Seed9-16` of the "wide" variant into `Seed1-8`.
+ */
+
+#define KOMIHASH_WIDEFOLD() \
+	Seed1 ^= Seed9; \
+	Seed2 ^= Seed10; \
+	Seed3 ^= Seed11; \
+	Seed4 ^= Seed12; \
+	Seed5 ^= Seed13; \
+	Seed6 ^= Seed14; \
+	Seed7 ^= Seed15; \
+	Seed8 ^= Seed16;
+
+/**
+ * @brief The "wide" variant's epilogue function (for internal use).
+ *
+ * Hashes the remaining part of the message (less than 128 bytes) after the
+ * 128-byte loop, and folds `Seed9-16`.
+ *
+ * @param Msg Pointer to the remaining part of the message.
+ * @param MsgLen Remaining part's length, less than 128, can be 0.
+ * @param Seed Latest `Seed1-16` values.
+ * @return 64-bit hash value.
+ */
+
+static KOMIHASH_INLINE uint64_t komihash_wide_epi( const uint8_t* Msg,
+	size_t MsgLen, const uint64_t* const Seed )
+{
+	uint64_t Seed1 = Seed[ 0 ] ^ Seed[ 8 ];
+	uint64_t Seed2 = Seed[ 1 ] ^ Seed[ 9 ];
+	uint64_t Seed3 = Seed[ 2 ] ^ Seed[ 10 ];
+	uint64_t Seed4 = Seed[ 3 ] ^ Seed[ 11 ];
+	uint64_t Seed5 = Seed[ 4 ] ^ Seed[ 12 ];
+	uint64_t Seed6 = Seed[ 5 ] ^ Seed[ 13 ];
+	uint64_t Seed7 = Seed[ 6 ] ^ Seed[ 14 ];
+	uint64_t Seed8 = Seed[ 7 ] ^ Seed[ 15 ];
+
+	if( MsgLen > 63 )
+	{
+		KOMIHASH_HASH64( Msg, Seed1, Seed2, Seed3, Seed4,
+			Seed5, Seed6, Seed7, Seed8 );
+
+		Msg += 64;
+		MsgLen -= 64;
+	}
+
+	Seed5 ^= Seed6 ^ Seed7 ^ Seed8;
+	Seed1 ^= Seed2 ^ Seed3 ^ Seed4;
+
+	return( komihash_epi( Msg, MsgLen, Seed1, Seed5 ));
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, "wide" variant.
+ *
+ * An opt-in variant for processors with a high multiplication throughput:
+ * messages of 128 bytes and longer are hashed by a loop that processes
+ * 128 bytes per iteration, using eight independent 128-bit multiplication
+ * lanes (`Seed1-16`), instead of four lanes and 64 bytes per iteration.
+ * Produces hash values that differ from those of the komihash() function,
+ * for messages of 128 bytes and longer; shorter messages produce equal hash
+ * values.
+ *
+ * @param Msg0 The message to produce a hash from. The alignment of this
+ * pointer is unimportant.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ * @return 64-bit hash of the input data.
+ */
+
+static inline uint64_t komihash_wide( const void* const Msg0, size_t MsgLen,
+	const uint64_t UseSeed )
+{
+	const uint8_t* Msg = (const uint8_t*) Msg0;
+
+	KOMIHASH_SEEDINIT();
+	KOMIHASH_PREFETCH( Msg );
+
+	if( KOMIHASH_LIKELY( MsgLen < 128 ))
+	{
+		return( komihash_body( Msg, MsgLen, Seed1, Seed5 ));
+	}
+
+	KOMIHASH_WIDEINIT();
+	KOMIHASH_HASHLOOP128();
+
+	const uint64_t Seed[ 16 ] = { Seed1, Seed2, Seed3, Seed4, Seed5, Seed6,
+		Seed7, Seed8, Seed9, Seed10, Seed11, Seed12, Seed13, Seed14, Seed15,
+		Seed16 };
+
+	return( komihash_wide_epi( Msg, MsgLen, Seed ));
+}
+
+/**
+ * @brief Context structure for the streamed "wide" variant hashing.
+ *
+ * Full 128-byte blocks are hashed directly from the input data, only the
+ * remaining part (less than 128 bytes) is buffered. The
+ * komihash_wstream_init() function should be called to initalize the
+ * structure before hashing.
+ */
+
+typedef struct {
+	uint64_t Seed[ 16 ]; ///< Hashing state variables.
+	uint8_t pb[ 8 ]; ///< Buffer's padding bytes, to avoid OOB.
+	uint8_t Buf[ 128 ]; ///< Buffer of the remaining part.
+	size_t BufFill; ///< Buffer fill count (position), in bytes.
+	size_t IsHashing; ///< 0 or 1, equals 1 if the actual hashing was started.
+} komihash_wstream_t;
+
+/**
+ * @brief Function initializes the streamed "wide" variant hashing session.
+ *
+ * @param[out] ctx Pointer to the context structure.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash_wide() function.
+ */
+
+static inline void komihash_wstream_init( komihash_wstream_t* const ctx,
+	const uint64_t UseSeed )
+{
+	KOMIHASH_SEEDINIT();
+	KOMIHASH_WIDEINIT();
+
+	ctx -> Seed[ 0 ] = Seed1;
+	ctx -> Seed[ 1 ] = Seed2;
+	ctx -> Seed[ 2 ] = Seed3;
+	ctx -> Seed[ 3 ] = Seed4;
+	ctx -> Seed[ 4 ] = Seed5;
+	ctx -> Seed[ 5 ] = Seed6;
+	ctx -> Seed[ 6 ] = Seed7;
+	ctx -> Seed[ 7 ] = Seed8;
+	ctx -> Seed[ 8 ] = Seed9;
+	ctx -> Seed[ 9 ] = Seed10;
+	ctx -> Seed[ 10 ] = Seed11;
+	ctx -> Seed[ 11 ] = Seed12;
+	ctx -> Seed[ 12 ] = Seed13;
+	ctx -> Seed[ 13 ] = Seed14;
+	ctx -> Seed[ 14 ] = Seed15;
+	ctx -> Seed[ 15 ] = Seed16;
+
+	memset( ctx -> pb, 0, sizeof( ctx -> pb ));
+	ctx -> BufFill = 0;
+	ctx -> IsHashing = 0;
+}
+
+/**
+ * @brief Function updates the streamed "wide" variant hashing state with a
+ * new input data.
+ *
+ * @param[in,out] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_wstream_init() function.
+ * @param Msg0 The next part of the whole message being hashed. The alignment
+ * of this pointer is unimportant. It is valid to pass 0 when `MsgLen` equals
+ * 0.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ */
+
+static inline void komihash_wstream_update( komihash_wstream_t* const ctx,
+	const void* const Msg0, size_t MsgLen )
+{
+	const uint8_t* Msg = (const uint8_t*) Msg0;
+	size_t BufFill = ctx -> BufFill;
+
+	if( BufFill + MsgLen < 128 )
+	{
+		if( MsgLen != 0 )
+		{
+			memcpy( ctx -> Buf + BufFill, Msg, MsgLen );
+			ctx -> BufFill = BufFill + MsgLen;
+		}
+
+		return;
+	}
+
+	// Since the whole message is at least 128 bytes long, all its full
+	// 128-byte blocks are hashed by the komihash_wide() function's loop.
+
+	uint64_t Seed1 = ctx -> Seed[ 0 ];
+	uint64_t Seed2 = ctx -> Seed[ 1 ];
+	uint64_t Seed3 = ctx -> Seed[ 2 ];
+	uint64_t Seed4 = ctx -> Seed[ 3 ];
+	uint64_t Seed5 = ctx -> Seed[ 4 ];
+	uint64_t Seed6 = ctx -> Seed[ 5 ];
+	uint64_t Seed7 = ctx -> Seed[ 6 ];
+	uint64_t Seed8 = ctx -> Seed[ 7 ];
+	uint64_t Seed9 = ctx -> Seed[ 8 ];
+	uint64_t Seed10 = ctx -> Seed[ 9 ];
+	uint64_t Seed11 = ctx -> Seed[ 10 ];
+	uint64_t Seed12 = ctx -> Seed[ 11 ];
+	uint64_t Seed13 = ctx -> Seed[ 12 ];
+	uint64_t Seed14 = ctx -> Seed[ 13 ];
+	uint64_t Seed15 = ctx -> Seed[ 14 ];
+	uint64_t Seed16 = ctx -> Seed[ 15 ];
+
+	if( BufFill != 0 )
+	{
+		const size_t CopyLen = 128 - BufFill;
+		memcpy( ctx -> Buf + BufFill, Msg, CopyLen );
+
+		Msg += CopyLen;
+		MsgLen -= CopyLen;
+
+		KOMIHASH_HASH128( ctx -> Buf );
+	}
+
+	if( MsgLen > 127 )
+	{
+		KOMIHASH_HASHLOOP128();
+	}
+
+	ctx -> Seed[ 0 ] = Seed1;
+	ctx -> Seed[ 1 ] = Seed2;
+	ctx -> Seed[ 2 ] = Seed3;
+	ctx -> Seed[ 3 ] = Seed4;
+	ctx -> Seed[ 4 ] = Seed5;
+	ctx -> Seed[ 5 ] = Seed6;
+	ctx -> Seed[ 6 ] = Seed7;
+	ctx -> Seed[ 7 ] = Seed8;
+	ctx -> Seed[ 8 ] = Seed9;
+	ctx -> Seed[ 9 ] = Seed10;
+	ctx -> Seed[ 10 ] = Seed11;
+	ctx -> Seed[ 11 ] = Seed12;
+	ctx -> Seed[ 12 ] = Seed13;
+	ctx -> Seed[ 13 ] = Seed14;
+	ctx -> Seed[ 14 ] = Seed15;
+	ctx -> Seed[ 15 ] = Seed16;
+	ctx -> IsHashing = 1;
+
+	memcpy( ctx -> Buf, Msg, MsgLen );
+	ctx -> BufFill = MsgLen;
+}
+
+/**
+ * @brief Function finalizes the streamed "wide" variant hashing session.
+ *
+ * Returns the resulting hash value of the previously hashed data. This value
+ * is equal to the value returned by the komihash_wide() function for the
+ * same provided data. This function is non-destructive to the context
+ * structure.
+ *
+ * @param[in] ctx Pointer to the context structure. The structure must be
+ * initialized via the komihash_wstream_init() function.
+ * @return 64-bit hash value.
+ */
+
+static inline uint64_t komihash_wstream_final(
+	const komihash_wstream_t* const ctx )
+{
+	if( ctx -> IsHashing == 0 )
+	{
+		return( komihash_body( ctx -> Buf, ctx -> BufFill, ctx -> Seed[ 0 ],
+			ctx -> Seed[ 4 ]));
+	}
+
+	return( komihash_wide_epi( ctx -> Buf, ctx -> BufFill, ctx -> Seed ));
+}
+
+/**
+ * @def KOMIHASH_TREE_VER
+ * @brief The version of the tree hashing mode definition.
+ *
+ * Tree hashing produces hash values that differ from those of the komihash()
+ * function. The message is split into KOMIHASH_TREE_LEAF-byte leaves (the
+ * last leaf can be shorter, a zero-length message has a single empty leaf).
+ * Each leaf is hashed via the komihash() function, with a seed derived from
+ * the leaf's index and `UseSeed`; the resulting root hash is the komihash()
+ * hash of the concatenation of the little-endian leaf hashes and the
+ * little-endian 64-bit message length, with the `UseSeed` seed. Leaves can
+ * be hashed in parallel.
+ */
+
+#define KOMIHASH_TREE_VER 1
+
+/**
+ * @def KOMIHASH_TREE_LEAF
+ * @brief The leaf size of the tree hashing mode, in bytes.
+ *
+ * This value is a part of the KOMIHASH_TREE_VER definition, and is not
+ * configurable.
+ */
+
+#define KOMIHASH_TREE_LEAF 1048576
+
+/**
+ * @def KOMIHASH_TREE_LEAFCOUNT( MsgLen )
+ * @brief Macro returns the number of leaves in a message, for the tree
+ * hashing mode.
+ * @param MsgLen Message's length, in bytes.
+ */
+
+#define KOMIHASH_TREE_LEAFCOUNT( MsgLen ) ( (MsgLen) == 0 ? 1 : \
+	( (MsgLen) - 1 ) / KOMIHASH_TREE_LEAF + 1 )
+
+/**
+ * @brief Function hashes a single leaf of a message, for the tree hashing
+ * mode.
+ *
+ * @param Msg Pointer to the whole message.
+ * @param MsgLen The whole message's length, in bytes, can be zero.
+ * @param LeafIndex Leaf's index, less than KOMIHASH_TREE_LEAFCOUNT( MsgLen ).
+ * @param UseSeed Optional value, to use instead of the default seed.
+ * @return Leaf's hash value.
+ */
+
+static inline uint64_t komihash_tree_leaf( const void* const Msg,
+	const size_t MsgLen, const size_t LeafIndex, const uint64_t UseSeed )
+{
+	const size_t Offs = LeafIndex * (size_t) KOMIHASH_TREE_LEAF;
+	const size_t LeafLen = ( MsgLen - Offs < KOMIHASH_TREE_LEAF ?
+		MsgLen - Offs : KOMIHASH_TREE_LEAF );
+
+	return( komihash( (const uint8_t*) Msg + Offs, LeafLen,
+		komihash_2x64( LeafIndex, KOMIHASH_TREE_VER, UseSeed )));
+}
+
+/**
+ * @brief Function produces the root hash of a message, for the tree hashing
+ * mode.
+ *
+ * @param LeafHashes Hashes of all message's leaves, produced via the
+ * komihash_tree_leaf() function.
+ * @param MsgLen The whole message's length, in bytes, can be zero.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as used for leaf hashing.
+ * @return 64-bit hash value.
+ */
+
+static inline uint64_t komihash_tree_root( const uint64_t* const LeafHashes,
+	const size_t MsgLen, const uint64_t UseSeed )
+{
+	const size_t LeafCount = KOMIHASH_TREE_LEAFCOUNT( MsgLen );
+	komihash_cstream_t ctx;
+	uint64_t v;
+	size_t i;
+
+	komihash_cstream_init( &ctx, UseSeed );
+
+	for( i = 0; i < LeafCount; i++ )
+	{
+		v = KOMIHASH_EC64( LeafHashes[ i ]);
+		komihash_cstream_update( &ctx, &v, 8 );
+	}
+
+	v = KOMIHASH_EC64( (uint64_t) MsgLen );
+	komihash_cstream_update( &ctx, &v, 8 );
+
+	return( komihash_cstream_final( &ctx ));
+}
+
+/**
+ * @brief KOMIHASH tree hashing mode, single-threaded implementation.
+ *
+ * @param Msg The message to produce a hash from. The alignment of this
+ * pointer is unimportant.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param UseSeed Optional value, to use instead of the default seed.
+ * @return 64-bit hash value, see KOMIHASH_TREE_VER for details.
+ */
+
+static inline uint64_t komihash_tree( const void* const Msg,
+	const size_t MsgLen, const uint64_t UseSeed )
+{
+	const size_t LeafCount = KOMIHASH_TREE_LEAFCOUNT( MsgLen );
+	komihash_cstream_t ctx;
+	uint64_t v;
+	size_t i;
+
+	komihash_cstream_init( &ctx, UseSeed );
+
+	for( i = 0; i < LeafCount; i++ )
+	{
+		v = KOMIHASH_EC64( komihash_tree_leaf( Msg, MsgLen, i, UseSeed ));
+		komihash_cstream_update( &ctx, &v, 8 );
+	}
+
+	v = KOMIHASH_EC64( (uint64_t) MsgLen );
+	komihash_cstream_update( &ctx, &v, 8 );
+
+	return( komihash_cstream_final( &ctx ));
+}
+
+#if defined( KOMIHASH_PTHREADS )
+
+#include <pthread.h>
+
+/**
+ * @def KOMIHASH_MT_MINLEN
+ * @brief The minimal length of data, in bytes, hashed by a single thread of
+ * the multi-threaded functions.
+ *
+ * The number of threads is reduced so that each thread hashes at least
+ * KOMIHASH_MT_MINLEN bytes, which keeps the overhead of starting threads
+ * low; data shorter than `2 * KOMIHASH_MT_MINLEN` bytes is hashed by the
+ * calling thread alone. Can be defined externally.
+ */
+
+#if !defined( KOMIHASH_MT_MINLEN )
+
+	#define KOMIHASH_MT_MINLEN 4194304
+
+#endif // !defined( KOMIHASH_MT_MINLEN )
+
+/**
+ * @brief Thread pool structure, for the multi-threaded functions.
+ *
+ * Holds threads that persist between calls of the multi-threaded functions
+ * (e.g., komihash_tree_mt_pool()), so that threads are not created and
+ * joined on each call. The komihash_pool_init() function should be called to
+ * initialize the structure, and the komihash_pool_destroy() function should
+ * be called to stop pool's threads. A pool can be used by a single calling
+ * thread at a time.
+ */
+
+typedef struct {
+	pthread_t th[ 255 ]; ///< Pool's threads.
+	int ThreadCount; ///< The number of pool's threads.
+	int Active; ///< The number of remaining task's thread slots.
+	int Running; ///< The number of task's unfinished thread slots.
+	int Quit; ///< 1, if pool's threads should exit.
+	size_t Gen; ///< Task's generation, incremented for each task.
+	void* ( *fn )( void* ); ///< Task's worker function.
+	void* p; ///< Task's worker function parameter.
+	pthread_mutex_t mx; ///< Mutex that guards the above variables.
+	pthread_cond_t StartCond; ///< Signaled when a task is started.
+	pthread_cond_t DoneCond; ///< Signaled when a task is finished.
+} komihash_pool_t;
+
+/**
+ * @brief Thread function of the thread pool (for internal use).
+ *
+ * The thread waits for a new task generation, and runs the task's worker
+ * function if a thread slot of the task is available.
+ *
+ * @param p0 Pointer to the komihash_pool_t structure.
+ * @return 0.
+ */
+
+static void* komihash_pool_thread( void* const p0 )
+{
+	komihash_pool_t* const pool = (komihash_pool_t*) p0;
+	size_t Gen = 0;
+
+	pthread_mutex_lock( &pool -> mx );
+
+	while( 1 )
+	{
+		while( pool -> Gen == Gen && pool -> Quit == 0 )
+		{
+			pthread_cond_wait( &pool -> StartCond, &pool -> mx );
+		}
+
+		if( pool -> Quit != 0 )
+		{
+			break;
+		}
+
+		Gen = pool -> Gen;
+
+		if( pool -> Active > 0 )
+		{
+			void* ( *const fn )( void* ) = pool -> fn;
+			void* const p = pool -> p;
+
+			pool -> Active--;
+			pthread_mutex_unlock( &pool -> mx );
+
+			fn( p );
+
+			pthread_mutex_lock( &pool -> mx );
+
+			if( --pool -> Running == 0 )
+			{
+				pthread_cond_signal( &pool -> DoneCond );
+			}
+		}
+	}
+
+	pthread_mutex_unlock( &pool -> mx );
+
+	return( 0 );
+}
+
+/**
+ * @brief Function initializes the thread pool, and starts its threads.
+ *
+ * @param[out] pool Pointer to the thread pool structure.
+ * @param ThreadCount The number of threads to use, including the calling
+ * thread, usually equal to the number of processor cores, up to 256. The
+ * pool starts `ThreadCount - 1` threads.
+ * @return The number of threads available, including the calling thread;
+ * can be lower than `ThreadCount`, if a thread cannot be created.
+ */
+
+static inline int komihash_pool_init( komihash_pool_t* const pool,
+	int ThreadCount )
+{
+	int i;
+
+	if( ThreadCount > 256 )
+	{
+		ThreadCount = 256;
+	}
+
+	pool -> ThreadCount = 0;
+	pool -> Active = 0;
+	pool -> Running = 0;
+	pool -> Quit = 0;
+	pool -> Gen = 0;
+
+	pthread_mutex_init( &pool -> mx, 0 );
+	pthread_cond_init( &pool -> StartCond, 0 );
+	pthread_cond_init( &pool -> DoneCond, 0 );
+
+	for( i = 1; i < ThreadCount; i++ )
+	{
+		if( pthread_create( &pool -> th[ pool -> ThreadCount ], 0,
+			komihash_pool_thread, pool ) == 0 )
+		{
+			pool -> ThreadCount++;
+		}
+	}
+
+	return( pool -> ThreadCount + 1 );
+}
+
+/**
+ * @brief Function stops and joins threads of the thread pool.
+ *
+ * @param[in,out] pool Pointer to the thread pool structure, initialized via
+ * the komihash_pool_init() function.
+ */
+
+static inline void komihash_pool_destroy( komihash_pool_t* const pool )
+{
+	int i;
+
+	pthread_mutex_lock( &pool -> mx );
+	pool -> Quit = 1;
+	pthread_cond_broadcast( &pool -> StartCond );
+	pthread_mutex_unlock( &pool -> mx );
+
+	for( i = 0; i < pool -> ThreadCount; i++ )
+	{
+		pthread_join( pool -> th[ i ], 0 );
+	}
+
+	pthread_cond_destroy( &pool -> DoneCond );
+	pthread_cond_destroy( &pool -> StartCond );
+	pthread_mutex_destroy( &pool -> mx );
+}
+
+/**
+ * @brief Function runs a worker function in several threads (for internal
+ * use).
+ *
+ * The worker function is run by `ThreadCount` threads, including the calling
+ * thread, or by fewer threads if `TotalLen` is small (see
+ * KOMIHASH_MT_MINLEN). Threads are taken from the thread pool, if `pool` is
+ * non-zero; otherwise, threads are created, and joined on return. If a thread
+ * cannot be created, the remaining threads are expected to perform its work.
+ * Returns when all threads have finished.
+ *
+ * @param fn Worker function.
+ * @param p Worker function's parameter, shared by all threads.
+ * @param ThreadCount The number of threads to use, up to 256.
+ * @param TotalLen The summary length of data to hash, in bytes.
+ * @param pool Thread pool, or 0.
+ */
+
+static inline void kh_run_threads( void* ( *fn )( void* ), void* const p,
+	int ThreadCount, const size_t TotalLen, komihash_pool_t* const pool )
+{
+	pthread_t th[ 255 ];
+	int i, c = 0;
+
+	if( ThreadCount > 256 )
+	{
+		ThreadCount = 256;
+	}
+
+	if( (size_t) ThreadCount > TotalLen / KOMIHASH_MT_MINLEN )
+	{
+		ThreadCount = (int) ( TotalLen / KOMIHASH_MT_MINLEN );
+	}
+
+	if( pool != 0 )
+	{
+		if( ThreadCount > pool -> ThreadCount + 1 )
+		{
+			ThreadCount = pool -> ThreadCount + 1;
+		}
+
+		if( ThreadCount < 2 )
+		{
+			fn( p );
+			return;
+		}
+
+		pthread_mutex_lock( &pool -> mx );
+		pool -> fn = fn;
+		pool -> p = p;
+		pool -> Active = ThreadCount - 1;
+		pool -> Running = ThreadCount - 1;
+		pool -> Gen++;
+		pthread_cond_broadcast( &pool -> StartCond );
+		pthread_mutex_unlock( &pool -> mx );
+
+		fn( p );
+
+		pthread_mutex_lock( &pool -> mx );
+
+		while( pool -> Running != 0 )
+		{
+			pthread_cond_wait( &pool -> DoneCond, &pool -> mx );
+		}
+
+		pthread_mutex_unlock( &pool -> mx );
+
+		return;
+	}
+
+	for( i = 1; i < ThreadCount; i++ )
+	{
+		if( pthread_create( &th[ c ], 0, fn, p ) == 0 )
+		{
+			c++;
+		}
+	}
+
+	fn( p );
+
+	for( i = 0; i < c; i++ )
+	{
+		pthread_join( th[ i ], 0 );
+	}
+}
+
+/**
+ * @brief Shared state of the multi-threaded tree hashing (for internal
+ * use).
+ */
+
+typedef struct {
+	const void* Msg; ///< Message pointer.
+	size_t MsgLen; ///< Message's length.
+	uint64_t UseSeed; ///< Seed value.
+	uint64_t* LeafHashes; ///< Resulting leaf hashes.
+	size_t NextLeaf; ///< The next leaf to hash, atomically incremented.
+} komihash_tree_mt_t;
+
+/**
+ * @brief Worker thread function of the multi-threaded tree hashing (for
+ * internal use).
+ *
+ * Threads take leaves in the order of their indices, until no leaves are
+ * left.
+ *
+ * @param p Pointer to the komihash_tree_mt_t structure.
+ * @return 0.
+ */
+
+static void* komihash_tree_mt_worker( void* const p )
+{
+	komihash_tree_mt_t* const st = (komihash_tree_mt_t*) p;
+	const size_t LeafCount = KOMIHASH_TREE_LEAFCOUNT( st -> MsgLen );
+
+	while( 1 )
+	{
+		const size_t i = __atomic_fetch_add( &st -> NextLeaf, 1,
+			__ATOMIC_RELAXED );
+
+		if( i >= LeafCount )
+		{
+			break;
+		}
+
+		st -> LeafHashes[ i ] = komihash_tree_leaf( st -> Msg, st -> MsgLen,
+			i, st -> UseSeed );
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief KOMIHASH tree hashing mode, multi-threaded implementation (for
+ * internal use).
+ *
+ * @param Msg The message to produce a hash from.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param UseSeed Seed value.
+ * @param[out] LeafHashes Storage for leaf hashes.
+ * @param ThreadCount The number of threads to use, up to 256.
+ * @param pool Thread pool, or 0.
+ * @return 64-bit hash value.
+ */
+
+static inline uint64_t kh_tree_mt( const void* const Msg,
+	const size_t MsgLen, const uint64_t UseSeed, uint64_t* const LeafHashes,
+	int ThreadCount, komihash_pool_t* const pool )
+{
+	const size_t LeafCount = KOMIHASH_TREE_LEAFCOUNT( MsgLen );
+	komihash_tree_mt_t st;
+
+	st.Msg = Msg;
+	st.MsgLen = MsgLen;
+	st.UseSeed = UseSeed;
+	st.LeafHashes = LeafHashes;
+	st.NextLeaf = 0;
+
+	if( (size_t) ThreadCount > LeafCount )
+	{
+		ThreadCount = (int) LeafCount;
+	}
+
+	kh_run_threads( komihash_tree_mt_worker, &st, ThreadCount, MsgLen, pool );
+
+	return( komihash_tree_root( LeafHashes, MsgLen, UseSeed ));
+}
+
+/**
+ * @brief KOMIHASH tree hashing mode, multi-threaded implementation.
+ *
+ * Produces a value equal to the value returned by the komihash_tree()
+ * function. Leaves are hashed by `ThreadCount` threads (including the
+ * calling thread), which take leaves dynamically. Threads are created on
+ * each call; the komihash_tree_mt_pool() function should be used instead,
+ * if messages are hashed repeatedly. Fewer threads are used for messages
+ * shorter than `ThreadCount * KOMIHASH_MT_MINLEN` bytes. Available if the
+ * KOMIHASH_PTHREADS macro is defined; requires POSIX threads and GCC-style
+ * atomic built-ins.
+ *
+ * @param Msg The message to produce a hash from.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param UseSeed Optional value, to use instead of the default seed.
+ * @param[out] LeafHashes Storage for leaf hashes, at least
+ * KOMIHASH_TREE_LEAFCOUNT( MsgLen ) elements.
+ * @param ThreadCount The number of threads to use, usually equal to the
+ * number of processor cores, up to 256.
+ * @return 64-bit hash value.
+ */
+
+static inline uint64_t komihash_tree_mt( const void* const Msg,
+	const size_t MsgLen, const uint64_t UseSeed, uint64_t* const LeafHashes,
+	const int ThreadCount )
+{
+	return( kh_tree_mt( Msg, MsgLen, UseSeed, LeafHashes, ThreadCount, 0 ));
+}
+
+/**
+ * @brief KOMIHASH tree hashing mode, multi-threaded implementation, with a
+ * thread pool.
+ *
+ * Equivalent to the komihash_tree_mt() function, but uses threads of the
+ * thread pool, and the calling thread.
+ *
+ * @param Msg The message to produce a hash from.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param UseSeed Optional value, to use instead of the default seed.
+ * @param[out] LeafHashes Storage for leaf hashes, at least
+ * KOMIHASH_TREE_LEAFCOUNT( MsgLen ) elements.
+ * @param pool Pointer to the thread pool structure, initialized via the
+ * komihash_pool_init() function.
+ * @return 64-bit hash value.
+ */
+
+static inline uint64_t komihash_tree_mt_pool( const void* const Msg,
+	const size_t MsgLen, const uint64_t UseSeed, uint64_t* const LeafHashes,
+	komihash_pool_t* const pool )
+{
+	return( kh_tree_mt( Msg, MsgLen, UseSeed, LeafHashes,
+		pool -> ThreadCount + 1, pool ));
+}
+
+/**
+ * @def KOMIHASH_MANY_TASK
+ * @brief The approximate maximal summary length of messages in a single task
+ * of the komihash_parallel_many() function, in bytes.
+ *
+ * Messages shorter than KOMIHASH_MANY_TASK bytes are grouped into tasks.
+ * Since messages are taken in the order of decreasing length, the number of
+ * messages in a group is derived from the length of its first (longest)
+ * message, and the summary length of a group does not exceed
+ * `KOMIHASH_MANY_TASK + l` bytes, where `l` is the length of its first
+ * message; groups of the shortest messages can be much shorter. Can be
+ * defined externally.
+ */
+
+#if !defined( KOMIHASH_MANY_TASK )
+
+	#define KOMIHASH_MANY_TASK 65536
+
+#endif // !defined( KOMIHASH_MANY_TASK )
+
+/**
+ * @brief Function sorts message indices in the order of decreasing message
+ * length, via heap-sort (for internal use).
+ *
+ * @param[in,out] Order Message indices.
+ * @param MsgLens Messages' lengths.
+ * @param n The number of indices.
+ */
+
+static inline void kh_many_sort( size_t* const Order,
+	const size_t* const MsgLens, const size_t n )
+{
+	size_t i = n / 2;
+	size_t m = n;
+
+	while( m > 1 )
+	{
+		size_t r, t;
+
+		if( i > 0 )
+		{
+			i--;
+			r = i;
+		}
+		else
+		{
+			m--;
+			t = Order[ 0 ];
+			Order[ 0 ] = Order[ m ];
+			Order[ m ] = t;
+			r = 0;
+		}
+
+		// Sift-down in a min-heap, by message length.
+
+		while( 1 )
+		{
+			size_t c = r * 2 + 1;
+
+			if( c >= m )
+			{
+				break;
+			}
+
+			if( c + 1 < m && MsgLens[ Order[ c + 1 ]] < MsgLens[ Order[ c ]])
+			{
+				c++;
+			}
+
+			if( MsgLens[ Order[ r ]] <= MsgLens[ Order[ c ]])
+			{
+				break;
+			}
+
+			t = Order[ r ];
+			Order[ r ] = Order[ c ];
+			Order[ c ] = t;
+			r = c;
+		}
+	}
+}
+
+/**
+ * @brief Shared state of the komihash_parallel_many() function (for
+ * internal use).
+ */
+
+typedef struct {
+	const void* const* Msgs; ///< Message pointers.
+	const size_t* MsgLens; ///< Messages' lengths.
+	const size_t* Order; ///< Message indices, by decreasing length.
+	size_t n; ///< The number of messages.
+	uint64_t UseSeed; ///< Seed value.
+	uint64_t* out; ///< Resulting hashes.
+	size_t Next; ///< The next position in `Order`, atomically advanced.
+} komihash_many_t;
+
+/**
+ * @brief Worker thread function of the komihash_parallel_many() function
+ * (for internal use).
+ *
+ * A thread takes the next task: either a single message, or a group of
+ * subsequent shorter messages, with a summary length of approximately at
+ * most KOMIHASH_MANY_TASK bytes.
+ *
+ * @param p Pointer to the komihash_many_t structure.
+ * @return 0.
+ */
+
+static void* komihash_many_worker( void* const p )
+{
+	komihash_many_t* const st = (komihash_many_t*) p;
+	const size_t* const Order = st -> Order;
+	const size_t* const MsgLens = st -> MsgLens;
+	const size_t n = st -> n;
+
+	while( 1 )
+	{
+		size_t i = __atomic_load_n( &st -> Next, __ATOMIC_RELAXED );
+		size_t e;
+
+		do
+		{
+			if( i >= n )
+			{
+				return( 0 );
+			}
+
+			const size_t l = MsgLens[ Order[ i ]];
+			e = i + ( l >= KOMIHASH_MANY_TASK ? 1 :
+				KOMIHASH_MANY_TASK / ( l + 64 ) + 1 );
+
+			if( e > n )
+			{
+				e = n;
+			}
+
+		} while( !__atomic_compare_exchange_n( &st -> Next, &i, e, 1,
+			__ATOMIC_RELAXED, __ATOMIC_RELAXED ));
+
+		while( i < e )
+		{
+			const size_t k = Order[ i ];
+			st -> out[ k ] = komihash_bulk( st -> Msgs[ k ], MsgLens[ k ],
+				st -> UseSeed );
+
+			i++;
+		}
+	}
+}
+
+/**
+ * @brief Multi-threaded hashing of many independent messages (for internal
+ * use).
+ *
+ * @param Msgs Pointers to messages.
+ * @param MsgLens Messages' lengths, in bytes, can be zero.
+ * @param n The number of messages.
+ * @param UseSeed Seed value.
+ * @param[out] out Resulting hash values, `n` elements.
+ * @param[out] Order Temporary storage, `n` elements.
+ * @param ThreadCount The number of threads to use, up to 256.
+ * @param pool Thread pool, or 0.
+ */
+
+static inline void kh_parallel_many( const void* const* const Msgs,
+	const size_t* const MsgLens, const size_t n, const uint64_t UseSeed,
+	uint64_t* const out, size_t* const Order, const int ThreadCount,
+	komihash_pool_t* const pool )
+{
+	komihash_many_t st;
+	size_t TotalLen = 0;
+	size_t i;
+
+	for( i = 0; i < n; i++ )
+	{
+		TotalLen += MsgLens[ i ];
+	}
+
+	if( ThreadCount < 2 || TotalLen / KOMIHASH_MT_MINLEN < 2 )
+	{
+		for( i = 0; i < n; i++ )
+		{
+			out[ i ] = komihash_bulk( Msgs[ i ], MsgLens[ i ], UseSeed );
+		}
+
+		return;
+	}
+
+	for( i = 0; i < n; i++ )
+	{
+		Order[ i ] = i;
+	}
+
+	kh_many_sort( Order, MsgLens, n );
+
+	st.Msgs = Msgs;
+	st.MsgLens = MsgLens;
+	st.Order = Order;
+	st.n = n;
+	st.UseSeed = UseSeed;
+	st.out = out;
+	st.Next = 0;
+
+	kh_run_threads( komihash_many_worker, &st, ThreadCount, TotalLen, pool );
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, multi-threaded hashing of many
+ * independent messages.
+ *
+ * Produces values equal to the values returned by the komihash() function
+ * for each message. Messages are scheduled in the order of decreasing
+ * length (the largest first), and are taken by `ThreadCount` threads
+ * (including the calling thread) dynamically, so that no thread stays idle
+ * while large messages are hashed. Short messages are grouped into tasks of
+ * approximately at most KOMIHASH_MANY_TASK bytes. Available if the
+ * KOMIHASH_PTHREADS macro is defined.
+ *
+ * This is not a work-stealing scheduler: all threads take tasks from a
+ * single shared cursor, advanced via an atomic compare-and-swap, which is
+ * sufficient since tasks are coarse. Threads are created on each call; the
+ * komihash_parallel_many_pool() function should be used instead, if it is
+ * called repeatedly. The sorting requires the caller-supplied `Order`
+ * storage, as the function does not allocate memory. If the summary length
+ * of messages is shorter than `2 * KOMIHASH_MT_MINLEN` bytes, messages are
+ * hashed by the calling thread, in their original order, without sorting;
+ * `Order` is not used in this case.
+ *
+ * @param Msgs Pointers to messages.
+ * @param MsgLens Messages' lengths, in bytes, can be zero.
+ * @param n The number of messages.
+ * @param UseSeed Optional value, to use instead of the default seed.
+ * @param[out] out Resulting hash values, `n` elements.
+ * @param[out] Order Temporary storage, `n` elements.
+ * @param ThreadCount The number of threads to use, usually equal to the
+ * number of processor cores, up to 256.
+ */
+
+static inline void komihash_parallel_many( const void* const* const Msgs,
+	const size_t* const MsgLens, const size_t n, const uint64_t UseSeed,
+	uint64_t* const out, size_t* const Order, const int ThreadCount )
+{
+	kh_parallel_many( Msgs, MsgLens, n, UseSeed, out, Order, ThreadCount, 0 );
+}
+
+/**
+ * @brief KOMIHASH 64-bit hash function, multi-threaded hashing of many
+ * independent messages, with a thread pool.
+ *
+ * Equivalent to the komihash_parallel_many() function, but uses threads of
+ * the thread pool, and the calling thread.
+ *
+ * @param Msgs Pointers to messages.
+ * @param MsgLens Messages' lengths, in bytes, can be zero.
+ * @param n The number of messages.
+ * @param UseSeed Optional value, to use instead of the default seed.
+ * @param[out] out Resulting hash values, `n` elements.
+ * @param[out] Order Temporary storage, `n` elements.
+ * @param pool Pointer to the thread pool structure, initialized via the
+ * komihash_pool_init() function.
+ */
+
+static inline void komihash_parallel_many_pool(
+	const void* const* const Msgs, const size_t* const MsgLens,
+	const size_t n, const uint64_t UseSeed, uint64_t* const out,
+	size_t* const Order, komihash_pool_t* const pool )
+{
+	kh_parallel_many( Msgs, MsgLens, n, UseSeed, out, Order,
+		pool -> ThreadCount + 1, pool );
+}
+
+#endif // defined( KOMIHASH_PTHREADS )
+
+#if defined( KOMIHASH_IOV )
+
+#include <sys/uio.h>
+
+/**
+ * @brief KOMIHASH 64-bit hash function, scatter-gather variant.
+ *
+ * Returns a value equal to the value returned by the komihash() function for
+ * the concatenation of all fragments. Full 64-byte blocks are hashed
+ * directly from the fragments, only blocks that cross fragment boundaries
+ * are assembled in a 64-byte buffer. Available on POSIX systems, if the
+ * KOMIHASH_IOV macro is defined before including `komihash.h` (this avoids
+ * including `sys/uio.h` by default).
+ *
+ * @param iov Fragments of the message. Fragments can have zero length.
+ * @param iovcnt The number of fragments.
+ * @param UseSeed Optional value, to use instead of the default seed, the
+ * same as in the komihash() function.
+ * @return 64-bit hash of the input data.
+ */
+
+static inline uint64_t komihash_iov( const struct iovec* const iov,
+	const int iovcnt, const uint64_t UseSeed )
+{
+	if( iovcnt == 1 )
+	{
+		return( komihash( iov[ 0 ].iov_base, iov[ 0 ].iov_len, UseSeed ));
+	}
+
+	komihash_cstream_t ctx;
+	int i;
+
+	komihash_cstream_init( &ctx, UseSeed );
+
+	for( i = 0; i < iovcnt; i++ )
+	{
+		komihash_cstream_update( &ctx, iov[ i ].iov_base, iov[ i ].iov_len );
+	}
+
+	return( komihash_cstream_final( &ctx ));
+}
+
+#endif // defined( KOMIHASH_IOV )
+
 #endif // KOMIHASH_INCLUDED
@@ -0,0 +1,265 @@
+/**
+ * @file komihash_cx.hpp
+ *
+ * @version 5.11
+ *
+ * @brief The inclusion file for the compile-time (constexpr) C++
+ * implementation of the "komihash" 64-bit hash function.
+ *
+ * Requires C++14. The komihash_cx() and komihash_cx_str() functions produce
+ * values equal to those produced by the komihash() function, but can be
+ * evaluated at compile time, e.g., in `static_assert` declarations and `case`
+ * labels. For run-time hashing, the komihash() function should be used
+ * instead, as it is considerably faster.
+ *
+ * Description is available at https://github.com/avaneev/komihash
+ *
+ * E-mail: aleksey.vaneev@gmail.com or info@voxengo.com
+ *
+ * LICENSE:
+ *
+ * Copyright (c) 2021-2024 Aleksey Vaneev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef KOMIHASH_CX_INCLUDED
+#define KOMIHASH_CX_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined( _MSVC_LANG )
+	#define KOMIHASH_CX_CPLUSPLUS _MSVC_LANG
+#else // defined( _MSVC_LANG )
+	#define KOMIHASH_CX_CPLUSPLUS __cplusplus
+#endif // defined( _MSVC_LANG )
+
+#if KOMIHASH_CX_CPLUSPLUS < 201402L
+	#error KOMIHASH: komihash_cx.hpp requires C++14.
+#endif // KOMIHASH_CX_CPLUSPLUS < 201402L
+
+/**
+ * @brief Compile-time 64-bit by 64-bit unsigned multiplication with result
+ * accumulation.
+ *
+ * Equivalent to the kh_m128() function, uses 32-bit by 32-bit
+ * multiplications.
+ *
+ * @param u Multiplier 1.
+ * @param v Multiplier 2.
+ * @param[out] rl The lower half of the 128-bit result.
+ * @param[in,out] rha The accumulator to receive the higher half of the
+ * 128-bit result.
+ */
+
+constexpr void kh_cx_m128( const uint64_t u, const uint64_t v,
+	uint64_t& rl, uint64_t& rha )
+{
+	const uint64_t u0 = (uint32_t) u;
+	const uint64_t v0 = (uint32_t) v;
+	const uint64_t w0 = u0 * v0;
+	const uint64_t u1 = u >> 32;
+	const uint64_t v1 = v >> 32;
+	const uint64_t t = u1 * v0 + ( w0 >> 32 );
+	const uint64_t w1 = u0 * v1 + (uint32_t) t;
+
+	rl = u * v;
+	rha += u1 * v1 + ( w1 >> 32 ) + ( t >> 32 );
+}
+
+/**
+ * @brief Compile-time load of unsigned 64-bit value, little-endian.
+ *
+ * @param p Pointer to 8 elements, only the lower 8 bits of each element are
+ * used.
+ * @return 64-bit value.
+ */
+
+template< typename T >
+constexpr uint64_t kh_cx_lu64( const T* const p )
+{
+	uint64_t v = 0;
+
+	for( int i = 7; i >= 0; i-- )
+	{
+		v = v << 8 | (uint8_t) p[ i ];
+	}
+
+	return( v );
+}
+
+/**
+ * @brief Compile-time load of unsigned 64-bit value with padding.
+ *
+ * Builds an unsigned 64-bit value out of remaining bytes in a message, and
+ * pads it with the "final byte", like the kh_lpu64ec_nz(),
+ * kh_lpu64ec_l3(), and kh_lpu64ec_l4() functions do.
+ *
+ * @param Msg Message pointer.
+ * @param MsgLen Message's remaining length, in bytes, less than 8, can be 0.
+ * @return Final byte-padded value from the message.
+ */
+
+template< typename T >
+constexpr uint64_t kh_cx_lpu64( const T* const Msg, const size_t MsgLen )
+{
+	uint64_t v = 1;
+
+	for( size_t i = MsgLen; i > 0; i-- )
+	{
+		v = v << 8 | (uint8_t) Msg[ i - 1 ];
+	}
+
+	return( v );
+}
+
+/**
+ * @brief Compile-time KOMIHASH 64-bit hash function.
+ *
+ * Produces a value equal to the value returned by the komihash() function,
+ * for the same message and seed.
+ *
+ * @param Msg The message to produce a hash from; `char`, `unsigned char`,
+ * or `uint8_t` elements are expected.
+ * @param MsgLen Message's length, in bytes, can be zero.
+ * @param UseSeed Optional value, to use instead of the default seed.
+ * @return 64-bit hash of the input data.
+ */
+
+template< typename T >
+constexpr uint64_t komihash_cx( const T* Msg, size_t MsgLen,
+	const uint64_t UseSeed = 0 )
+{
+	uint64_t Seed1 = 0x243F6A8885A308D3 ^ ( UseSeed & 0x5555555555555555 );
+	uint64_t Seed5 = 0x452821E638D01377 ^ ( UseSeed & 0xAAAAAAAAAAAAAAAA );
+	uint64_t r1h = 0;
+	uint64_t r2h = 0;
+
+	kh_cx_m128( Seed1, Seed5, Seed1, Seed5 );
+	Seed1 ^= Seed5;
+
+	if( MsgLen < 16 )
+	{
+		r1h = Seed1;
+		r2h = Seed5;
+
+		if( MsgLen > 7 )
+		{
+			r2h ^= kh_cx_lpu64( Msg + 8, MsgLen - 8 );
+			r1h ^= kh_cx_lu64( Msg );
+		}
+		else
+		if( MsgLen != 0 )
+		{
+			r1h ^= kh_cx_lpu64( Msg, MsgLen );
+		}
+	}
+	else
+	{
+		if( MsgLen > 63 )
+		{
+			uint64_t Seed2 = 0x13198A2E03707344 ^ Seed1;
+			uint64_t Seed3 = 0xA4093822299F31D0 ^ Seed1;
+			uint64_t Seed4 = 0x082EFA98EC4E6C89 ^ Seed1;
+			uint64_t Seed6 = 0xBE5466CF34E90C6C ^ Seed5;
+			uint64_t Seed7 = 0xC0AC29B7C97C50DD ^ Seed5;
+			uint64_t Seed8 = 0x3F84D5B5B5470917 ^ Seed5;
+
+			do
+			{
+				kh_cx_m128( Seed1 ^ kh_cx_lu64( Msg ),
+					Seed5 ^ kh_cx_lu64( Msg + 32 ), Seed1, Seed5 );
+
+				kh_cx_m128( Seed2 ^ kh_cx_lu64( Msg + 8 ),
+					Seed6 ^ kh_cx_lu64( Msg + 40 ), Seed2, Seed6 );
+
+				kh_cx_m128( Seed3 ^ kh_cx_lu64( Msg + 16 ),
+					Seed7 ^ kh_cx_lu64( Msg + 48 ), Seed3, Seed7 );
+
+				kh_cx_m128( Seed4 ^ kh_cx_lu64( Msg + 24 ),
+					Seed8 ^ kh_cx_lu64( Msg + 56 ), Seed4, Seed8 );
+
+				Msg += 64;
+				MsgLen -= 64;
+
+				Seed2 ^= Seed5;
+				Seed3 ^= Seed6;
+				Seed4 ^= Seed7;
+				Seed1 ^= Seed8;
+
+			} while( MsgLen > 63 );
+
+			Seed5 ^= Seed6 ^ Seed7 ^ Seed8;
+			Seed1 ^= Seed2 ^ Seed3 ^ Seed4;
+		}
+
+		// The komihash_epi() function's logic, and the 16-31-byte branch of
+		// the komihash() function (which are equivalent).
+
+		while( MsgLen > 15 )
+		{
+			kh_cx_m128( Seed1 ^ kh_cx_lu64( Msg ),
+				Seed5 ^ kh_cx_lu64( Msg + 8 ), Seed1, Seed5 );
+
+			Seed1 ^= Seed5;
+
+			Msg += 16;
+			MsgLen -= 16;
+		}
+
+		if( MsgLen > 7 )
+		{
+			r2h = Seed5 ^ kh_cx_lpu64( Msg + 8, MsgLen - 8 );
+			r1h = Seed1 ^ kh_cx_lu64( Msg );
+		}
+		else
+		{
+			r1h = Seed1 ^ kh_cx_lpu64( Msg, MsgLen );
+			r2h = Seed5;
+		}
+	}
+
+	kh_cx_m128( r1h, r2h, Seed1, Seed5 );
+	Seed1 ^= Seed5;
+
+	kh_cx_m128( Seed1, Seed5, Seed1, Seed5 );
+	Seed1 ^= Seed5;
+
+	return( Seed1 );
+}
+
+/**
+ * @brief Compile-time KOMIHASH 64-bit hash function, for string literals.
+ *
+ * The terminating zero of the string literal is not hashed.
+ *
+ * @param Str String literal.
+ * @param UseSeed Optional value, to use instead of the default seed.
+ * @return 64-bit hash of the string.
+ */
+
+template< size_t N >
+constexpr uint64_t komihash_cx_str( const char ( &Str )[ N ],
+	const uint64_t UseSeed = 0 )
+{
+	return( komihash_cx( Str + 0, N - 1, UseSeed ));
+}
+
+#endif // KOMIHASH_CX_INCLUDED
@@ -0,0 +1,126 @@
+/**
+ * testcx.cpp version 5.11
+ *
+ * The program that checks that the compile-time komihash_cx() and
+ * komihash_cx_str() functions produce values equal to those of the
+ * komihash() function. Requires C++14. Compile-time values are checked via
+ * `static_assert` declarations (the program does not compile if any check
+ * fails), for messages that cover all length branches of komihash(); then
+ * all message lengths up to 300 bytes are checked at run time.
+ *
+ * Description is available at https://github.com/avaneev/komihash
+ *
+ * License
+ *
+ * Copyright (c) 2021-2024 Aleksey Vaneev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include "komihash.h"
+#include "komihash_cx.hpp"
+
+// Values produced by the komihash() function, with seeds 0 and
+// 0x0123456789ABCDEF.
+
+#define KOMIHASH_CX_CHECK( s, h0, h1 ) \
+	static_assert( komihash_cx_str( s ) == h0, s ); \
+	static_assert( komihash_cx_str( s, 0x0123456789ABCDEF ) == h1, s );
+
+KOMIHASH_CX_CHECK( "", 0xB7683EA7430132B4, 0x269707E5BF5FBE07 )
+KOMIHASH_CX_CHECK( "abc", 0x03B74DC61A6B7F33, 0xD4106F3EBB74A844 )
+KOMIHASH_CX_CHECK( "7 chars", 0x2C514F6E5DCB11CB, 0x90AB7C9F831CD940 )
+KOMIHASH_CX_CHECK( "8 chars!", 0xFB090DDBCA7FD4F5, 0x1F4EA9EBB41F383B )
+KOMIHASH_CX_CHECK( "15-byte string.", 0x769CDE461D1D78B3,
+	0xE8199D161B4A0BDD )
+
+KOMIHASH_CX_CHECK( "A 16-byte string", 0x467CAA28EA3DA7A6,
+	0x26AF914213D0C915 )
+
+KOMIHASH_CX_CHECK( "The cat is out of the bag", 0xD15723521D3C37B1,
+	0x5B1DA0B43545D196 )
+
+KOMIHASH_CX_CHECK( "This is a 32-byte testing string", 0x05AD960802903A9D,
+	0x6CE66A2E8D4979A5 )
+
+KOMIHASH_CX_CHECK(
+	"A 63-byte string, hashed by the 16-byte rounds of the epilogue.",
+	0x1D1281B069ACBDE9, 0xB302C5C94A545638 )
+
+KOMIHASH_CX_CHECK(
+	"A 64-byte string, the shortest one hashed by the 64-byte loop...",
+	0x79994E0AA05EA7DF, 0x485EB21FB8CF0D4D )
+
+KOMIHASH_CX_CHECK(
+	"A 150-byte string: hashed by two iterations of the 64-byte loop, then "
+	"its 22-byte remainder is hashed by the epilogue's 16-byte round and "
+	"final words.", 0x9FE29A13CFDD2AEE, 0x208C152F7DAD564C )
+
+// Hash values can be used as `case` labels.
+
+static int verb_id( const char* const s, const size_t l )
+{
+	switch( komihash( s, l, 0 ))
+	{
+		case komihash_cx_str( "GET" ):
+			return( 1 );
+
+		case komihash_cx_str( "POST" ):
+			return( 2 );
+	}
+
+	return( 0 );
+}
+
+int main()
+{
+	const uint64_t seeds[ 3 ] = { 0, 0x0123456789ABCDEF, 256 };
+	uint8_t buf[ 300 ];
+	size_t i;
+	int j;
+
+	for( i = 0; i < sizeof( buf ); i++ )
+	{
+		buf[ i ] = (uint8_t) ( i * 7 + 3 );
+	}
+
+	for( j = 0; j < 3; j++ )
+	{
+		for( i = 0; i <= sizeof( buf ); i++ )
+		{
+			if( komihash_cx( buf, i, seeds[ j ]) !=
+				komihash( buf, i, seeds[ j ]))
+			{
+				printf( "komihash_cx() mismatch, length %i\n", (int) i );
+				return( 1 );
+			}
+		}
+	}
+
+	if( verb_id( "POST", 4 ) != 2 || verb_id( "PUT", 3 ) != 0 )
+	{
+		printf( "komihash_cx_str() `case` label mismatch\n" );
+		return( 1 );
+	}
+
+	printf( "komihash_cx() tests passed\n" );
+
+	return( 0 );
+}
@@ -0,0 +1,1353 @@
+/**
+ * testeq.c version 5.11
+ *
+ * The program that checks that the specialized komihash functions produce
+ * values equal to those of the equivalent komihash() and streamed hashing
+ * function calls, on pseudo-random data and call sequences. Prints the
+ * name of a failed check and returns 1 if any check fails. Can be compiled
+ * as C++, to check C++-only functions as well. Optional functions are
+ * checked if the respective macros are defined (e.g., via the
+ * `-DKOMIHASH_IOV` option; multi-threaded functions via the
+ * `-DKOMIHASH_PTHREADS -pthread` options).
+ *
+ * Description is available at https://github.com/avaneev/komihash
+ *
+ * License
+ *
+ * Copyright (c) 2021-2024 Aleksey Vaneev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined( KOMIHASH_PTHREADS ) && !defined( KOMIHASH_MT_MINLEN )
+
+	#define KOMIHASH_MT_MINLEN 65536 // Use several threads on short data.
+
+#endif // defined( KOMIHASH_PTHREADS ) && !defined( KOMIHASH_MT_MINLEN )
+
+#include "komihash.h"
+
+static uint64_t test_Seed1 = 1; // PRNG state of the tests.
+static uint64_t test_Seed2 = 1;
+
+/**
+ * @brief Returns a pseudo-random value in the range [0; n).
+ */
+
+static size_t test_rand( const size_t n )
+{
+	return( (size_t) ( komirand( &test_Seed1, &test_Seed2 ) % n ));
+}
+
+/**
+ * @brief Returns a pseudo-random 64-bit value.
+ */
+
+static uint64_t test_rand64()
+{
+	return( komirand( &test_Seed1, &test_Seed2 ));
+}
+
+/**
+ * @brief Fills a buffer with pseudo-random bytes.
+ */
+
+static void test_fill( uint8_t* const p, const size_t l )
+{
+	size_t i;
+
+	for( i = 0; i < l; i++ )
+	{
+		p[ i ] = (uint8_t) test_rand( 256 );
+	}
+}
+
+/**
+ * @brief Updates a streamed hashing session with a message, in chunks of
+ * random lengths.
+ */
+
+static void test_stream_chunks( komihash_stream_t* const ctx,
+	const uint8_t* const m, const size_t l )
+{
+	size_t p = 0;
+
+	while( p < l )
+	{
+		size_t q = test_rand( 300 );
+		q = ( q > l - p ? l - p : q );
+
+		komihash_stream_update( ctx, m + p, q );
+		p += q;
+	}
+}
+
+/**
+ * @brief Hashing with a precomputed seed state (komihash_with_key()), and
+ * streamed hashing initialized via komihash_stream_init_key(), versus
+ * komihash().
+ */
+
+static int test_key()
+{
+	static uint8_t m[ 1000 ];
+	int t;
+
+	test_fill( m, sizeof( m ));
+
+	for( t = 0; t < 5000; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const size_t l = ( t < 1000 ? (size_t) t : test_rand( sizeof( m ) + 1 ));
+		komihash_key_t key;
+		komihash_stream_t ctx;
+
+		komihash_key_init( &key, Seed );
+		const uint64_t h = komihash( m, l, Seed );
+
+		if( komihash_with_key( m, l, &key ) != h )
+		{
+			return( 1 );
+		}
+
+		komihash_stream_init_key( &ctx, &key );
+		test_stream_chunks( &ctx, m, l );
+
+		if( komihash_stream_final( &ctx ) != h )
+		{
+			return( 1 );
+		}
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief Fixed-width value hashing (komihash_u32/u64/2x64/u128()), versus
+ * komihash() of values' little-endian representations.
+ */
+
+static int test_fixed()
+{
+	int t;
+
+	for( t = 0; t < 100000; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const uint64_t v1 = test_rand64();
+		const uint64_t v2 = test_rand64();
+		uint8_t le[ 16 ];
+		int j;
+
+		for( j = 0; j < 8; j++ )
+		{
+			le[ j ] = (uint8_t) ( v1 >> j * 8 );
+			le[ 8 + j ] = (uint8_t) ( v2 >> j * 8 );
+		}
+
+		if( komihash_u32( (uint32_t) v1, Seed ) != komihash( le, 4, Seed ) ||
+			komihash_u64( v1, Seed ) != komihash( le, 8, Seed ) ||
+			komihash_2x64( v1, v2, Seed ) != komihash( le, 16, Seed ))
+		{
+			return( 1 );
+		}
+
+	#if defined( __SIZEOF_INT128__ )
+
+		if( komihash_u128( (kh_u128_t) v2 << 64 | v1, Seed ) !=
+			komihash( le, 16, Seed ))
+		{
+			return( 1 );
+		}
+
+	#endif // defined( __SIZEOF_INT128__ )
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief Padded-buffer hashing (komihash_padded()), versus komihash(), for
+ * lengths 0-64. Messages are placed at the end of a buffer that has just the
+ * required 16 bytes of padding after the message.
+ */
+
+static int test_padded()
+{
+	uint8_t b[ 64 + 16 ];
+	size_t l;
+	int t;
+
+	for( t = 0; t < 2000; t++ )
+	{
+		const uint64_t Seed = ( t == 0 ? 0 : test_rand64() );
+
+		test_fill( b, sizeof( b ));
+
+		for( l = 0; l <= 64; l++ )
+		{
+			const uint8_t* const m = b + 64 - l;
+
+			if( komihash_padded( m, l, Seed ) != komihash( m, l, Seed ))
+			{
+				return( 1 );
+			}
+		}
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief Multi-buffer streamed hashing (komihash_stream_update_mb()) of 1-7
+ * messages, in chunks of random lengths, versus komihash() of each message.
+ */
+
+static int test_mb()
+{
+	static uint8_t m[ 7 ][ 3000 ];
+	komihash_stream_t ctx[ 7 ];
+	komihash_stream_t* ctxs[ 7 ];
+	const void* Msgs[ 7 ];
+	size_t MsgLens[ 7 ];
+	size_t l[ 7 ], p[ 7 ];
+	uint64_t Seed[ 7 ];
+	size_t i;
+	int t;
+
+	test_fill( m[ 0 ], sizeof( m ));
+
+	for( t = 0; t < 2000; t++ )
+	{
+		const size_t n = 1 + test_rand( 7 );
+		int Left = 1;
+
+		for( i = 0; i < n; i++ )
+		{
+			l[ i ] = test_rand( sizeof( m[ 0 ]) + 1 );
+			p[ i ] = 0;
+			Seed[ i ] = test_rand64();
+			ctxs[ i ] = ctx + i;
+
+			komihash_stream_init( ctx + i, Seed[ i ]);
+		}
+
+		while( Left )
+		{
+			Left = 0;
+
+			for( i = 0; i < n; i++ )
+			{
+				size_t q = ( test_rand( 4 ) == 0 ? test_rand( 64 ) :
+					test_rand( 1000 ));
+
+				q = ( q > l[ i ] - p[ i ] ? l[ i ] - p[ i ] : q );
+
+				Msgs[ i ] = m[ i ] + p[ i ];
+				MsgLens[ i ] = q;
+				p[ i ] += q;
+				Left |= ( p[ i ] < l[ i ]);
+			}
+
+			komihash_stream_update_mb( ctxs, Msgs, MsgLens, n );
+		}
+
+		for( i = 0; i < n; i++ )
+		{
+			if( komihash_stream_final( ctx + i ) !=
+				komihash( m[ i ], l[ i ], Seed[ i ]))
+			{
+				return( 1 );
+			}
+		}
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief Compact streamed hashing (komihash_cstream_t), in chunks of random
+ * lengths, versus komihash(). Intermediate komihash_cstream_final() calls
+ * are checked as well.
+ */
+
+static int test_cstream()
+{
+	static uint8_t m[ 3000 ];
+	int t;
+
+	test_fill( m, sizeof( m ));
+
+	for( t = 0; t < 3000; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const size_t l = test_rand( sizeof( m ) + 1 );
+		komihash_cstream_t ctx;
+		size_t p = 0;
+
+		komihash_cstream_init( &ctx, Seed );
+
+		while( p < l )
+		{
+			size_t q = ( test_rand( 2 ) == 0 ? test_rand( 80 ) :
+				test_rand( 300 ));
+
+			q = ( q > l - p ? l - p : q );
+
+			komihash_cstream_update( &ctx, m + p, q );
+			p += q;
+
+			if( komihash_cstream_final( &ctx ) != komihash( m, p, Seed ))
+			{
+				return( 1 );
+			}
+		}
+
+		if( komihash_cstream_final( &ctx ) != komihash( m, l, Seed ))
+		{
+			return( 1 );
+		}
+	}
+
+	return( 0 );
+}
+
+#if defined( KOMIHASH_IOV )
+
+/**
+ * @brief Scatter-gather hashing (komihash_iov()) of a message split into
+ * 1-16 fragments of random lengths, including zero-length ones, versus
+ * komihash().
+ */
+
+static int test_iov()
+{
+	static uint8_t m[ 3000 ];
+	struct iovec iov[ 16 ];
+	int t, i;
+
+	test_fill( m, sizeof( m ));
+
+	for( t = 0; t < 5000; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const size_t l = test_rand( sizeof( m ) + 1 );
+		const int iovcnt = 1 + (int) test_rand( 16 );
+		size_t p = 0;
+
+		for( i = 0; i < iovcnt; i++ )
+		{
+			size_t q = ( i == iovcnt - 1 ? l - p : test_rand( 200 ));
+			q = ( q > l - p ? l - p : q );
+
+			iov[ i ].iov_base = m + p;
+			iov[ i ].iov_len = q;
+			p += q;
+		}
+
+		if( komihash_iov( iov, iovcnt, Seed ) != komihash( m, l, Seed ))
+		{
+			return( 1 );
+		}
+	}
+
+	return( 0 );
+}
+
+#endif // defined( KOMIHASH_IOV )
+
+/**
+ * @brief Large message hashing (komihash_bulk()), versus komihash(), for
+ * lengths around the 256-byte threshold and the KOMIHASH_BULK_PFDIST
+ * prefetch distance, and random lengths.
+ */
+
+static int test_bulk()
+{
+	static uint8_t m[ KOMIHASH_BULK_PFDIST * 4 + 1000 ];
+	int t;
+
+	test_fill( m, sizeof( m ));
+
+	for( t = 0; t < 3000; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		size_t l;
+
+		switch( t % 3 )
+		{
+			case 0:
+				l = 192 + test_rand( 128 );
+				break;
+
+			case 1:
+				l = KOMIHASH_BULK_PFDIST + test_rand( 256 );
+				break;
+
+			default:
+				l = test_rand( sizeof( m ) + 1 );
+				break;
+		}
+
+		if( komihash_bulk( m, l, Seed ) != komihash( m, l, Seed ))
+		{
+			return( 1 );
+		}
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief Converts `A-Z` bytes to `a-z`, for the case-insensitive hashing
+ * tests.
+ */
+
+static void test_lower( uint8_t* const op, const uint8_t* const ip,
+	const size_t l )
+{
+	size_t i;
+
+	for( i = 0; i < l; i++ )
+	{
+		op[ i ] = (uint8_t) ( ip[ i ] >= 'A' && ip[ i ] <= 'Z' ?
+			ip[ i ] + 32 : ip[ i ]);
+	}
+}
+
+/**
+ * @brief Case-insensitive hashing (komihash_ci()), versus komihash() of the
+ * lowercase-converted message, for lengths 0-300. Then streamed hashing via
+ * komihash_stream_update_ci() in chunks of random lengths, mixed with
+ * komihash_stream_update() calls, versus komihash() of a message with only
+ * the komihash_stream_update_ci() chunks converted. Messages consist mostly
+ * of letters, to exercise the conversion.
+ */
+
+static int test_ci()
+{
+	static uint8_t m[ 3000 ];
+	static uint8_t lm[ 3000 ];
+	int t;
+	size_t i;
+
+	for( i = 0; i < sizeof( m ); i++ )
+	{
+		const size_t r = test_rand( 4 );
+
+		m[ i ] = (uint8_t) ( r == 0 ? test_rand( 256 ) :
+			( r == 1 ? 'A' : 'a' ) + test_rand( 26 ));
+	}
+
+	for( t = 0; t < 5000; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const size_t l = ( t <= 300 ? (size_t) t : test_rand( 301 ));
+		const size_t o = test_rand( sizeof( m ) - l + 1 );
+
+		test_lower( lm, m + o, l );
+
+		if( komihash_ci( m + o, l, Seed ) != komihash( lm, l, Seed ))
+		{
+			return( 1 );
+		}
+	}
+
+	for( t = 0; t < 3000; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const size_t l = test_rand( sizeof( m ) + 1 );
+		const int Mixed = ( t % 2 != 0 );
+		komihash_stream_t ctx;
+		size_t p = 0;
+
+		komihash_stream_init( &ctx, Seed );
+
+		while( p < l )
+		{
+			size_t q = test_rand( 300 );
+			q = ( q > l - p ? l - p : q );
+
+			if( Mixed && test_rand( 2 ) == 0 )
+			{
+				komihash_stream_update( &ctx, m + p, q );
+				memcpy( lm + p, m + p, q );
+			}
+			else
+			{
+				komihash_stream_update_ci( &ctx, m + p, q );
+				test_lower( lm + p, m + p, q );
+			}
+
+			p += q;
+		}
+
+		if( komihash_stream_final( &ctx ) != komihash( lm, l, Seed ))
+		{
+			return( 1 );
+		}
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief "Wide" variant hashing (komihash_wide()), versus streamed "wide"
+ * variant hashing (komihash_wstream_update()) in chunks of random lengths,
+ * and versus komihash() for messages shorter than 128 bytes.
+ */
+
+static int test_wide()
+{
+	static uint8_t m[ 3000 ];
+	int t;
+
+	test_fill( m, sizeof( m ));
+
+	for( t = 0; t < 5000; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const size_t l = ( t < 1000 ? (size_t) t : test_rand( sizeof( m ) + 1 ));
+		const uint64_t h = komihash_wide( m, l, Seed );
+		komihash_wstream_t ctx;
+		size_t p = 0;
+
+		if( l < 128 && h != komihash( m, l, Seed ))
+		{
+			return( 1 );
+		}
+
+		komihash_wstream_init( &ctx, Seed );
+
+		while( p < l )
+		{
+			size_t q = test_rand( 300 );
+			q = ( q > l - p ? l - p : q );
+
+			komihash_wstream_update( &ctx, m + p, q );
+			p += q;
+		}
+
+		if( komihash_wstream_final( &ctx ) != h )
+		{
+			return( 1 );
+		}
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief 128-bit hashing (komihash128()), versus komihash() for the lower
+ * half, and versus streamed hashing finalized via komihash_stream_final128(),
+ * with random split points.
+ */
+
+static int test_h128()
+{
+	static uint8_t m[ 3000 ];
+	int t;
+
+	test_fill( m, sizeof( m ));
+
+	for( t = 0; t < 5000; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const size_t l = ( t < 1000 ? (size_t) t : test_rand( sizeof( m ) + 1 ));
+		komihash_stream_t ctx;
+		uint64_t h[ 2 ];
+		uint64_t hs[ 2 ];
+
+		komihash128( m, l, Seed, h );
+
+		if( h[ 0 ] != komihash( m, l, Seed ))
+		{
+			return( 1 );
+		}
+
+		komihash_stream_init( &ctx, Seed );
+		test_stream_chunks( &ctx, m, l );
+		komihash_stream_final128( &ctx, hs );
+
+		if( hs[ 0 ] != h[ 0 ] || hs[ 1 ] != h[ 1 ])
+		{
+			return( 1 );
+		}
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief Multi-seed hashing (komihash_multi()) of a message with 0-9 random
+ * seeds, versus komihash() with each seed.
+ */
+
+static int test_multi()
+{
+	static uint8_t m[ 1000 ];
+	uint64_t Seeds[ 9 ];
+	uint64_t out[ 9 ];
+	int t, i;
+
+	test_fill( m, sizeof( m ));
+
+	for( t = 0; t < 5000; t++ )
+	{
+		const size_t l = ( t < 1000 ? (size_t) t : test_rand( sizeof( m ) + 1 ));
+		const int k = t % 10;
+
+		for( i = 0; i < k; i++ )
+		{
+			Seeds[ i ] = test_rand64();
+		}
+
+		komihash_multi( m, l, Seeds, k, out );
+
+		for( i = 0; i < k; i++ )
+		{
+			if( out[ i ] != komihash( m, l, Seeds[ i ]))
+			{
+				return( 1 );
+			}
+		}
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief Scattered message hashing (komihash_ptrs()), versus komihash() of
+ * each message, with and without bucket index output, for random message
+ * counts around the KOMIHASH_PTRS_PFAHEAD prefetch distance.
+ */
+
+static int test_ptrs()
+{
+	static uint8_t m[ 3000 ];
+	static const void* Msgs[ KOMIHASH_PTRS_PFAHEAD * 2 + 50 ];
+	static size_t MsgLens[ KOMIHASH_PTRS_PFAHEAD * 2 + 50 ];
+	static uint64_t out[ KOMIHASH_PTRS_PFAHEAD * 2 + 50 ];
+	static size_t Buckets[ KOMIHASH_PTRS_PFAHEAD * 2 + 50 ];
+	int t;
+	size_t i;
+
+	test_fill( m, sizeof( m ));
+
+	for( t = 0; t < 3000; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const size_t n = test_rand( KOMIHASH_PTRS_PFAHEAD * 2 + 51 );
+		const size_t TableSize = (size_t) 1 << test_rand( 20 );
+		size_t* const b = ( t % 2 == 0 ? Buckets : 0 );
+
+		for( i = 0; i < n; i++ )
+		{
+			const size_t l = test_rand( 300 );
+
+			Msgs[ i ] = m + test_rand( sizeof( m ) - l + 1 );
+			MsgLens[ i ] = l;
+		}
+
+		komihash_ptrs( Msgs, MsgLens, n, Seed, out, TableSize, b );
+
+		for( i = 0; i < n; i++ )
+		{
+			const uint64_t h = komihash( Msgs[ i ], MsgLens[ i ], Seed );
+
+			if( out[ i ] != h ||
+				( b != 0 && b[ i ] != ( (size_t) h & ( TableSize - 1 ))))
+			{
+				return( 1 );
+			}
+		}
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief Record field hashing (komihash_strided()), versus komihash() of each
+ * record's field, for random strides, field offsets and lengths, and record
+ * counts.
+ */
+
+static int test_strided()
+{
+	static uint8_t m[ 5000 ];
+	static uint64_t out[ 50 ];
+	int t;
+	size_t i;
+
+	test_fill( m, sizeof( m ));
+
+	for( t = 0; t < 3000; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const size_t Stride = 1 + test_rand( 100 );
+		const size_t FieldLen = test_rand( Stride + 1 );
+		const size_t FieldOffset = test_rand( Stride - FieldLen + 1 );
+		const size_t Count = test_rand( 51 );
+
+		komihash_strided( m, Stride, FieldOffset, FieldLen, Count, Seed, out );
+
+		for( i = 0; i < Count; i++ )
+		{
+			if( out[ i ] != komihash( m + Stride * i + FieldOffset, FieldLen,
+				Seed ))
+			{
+				return( 1 );
+			}
+		}
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief Column string hashing (komihash_column_strings(),
+ * komihash_column_strings_v(), komihash_column_strings32_v()), versus
+ * komihash() of each row's string, with random validity bitmaps; null rows
+ * should produce NullHash. Column's data is allocated with its exact length,
+ * so that over-reading can be detected via sanitizers.
+ */
+
+static int test_colstr()
+{
+	static int64_t Offs[ 501 ];
+	static int32_t Offs32[ 501 ];
+	static uint8_t Validity[ 63 ];
+	static uint64_t out[ 500 ];
+	int t;
+	size_t i;
+
+	for( t = 0; t < 300; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const uint64_t NullHash = test_rand64();
+		const size_t Rows = test_rand( 501 );
+		size_t l = 0;
+
+		for( i = 0; i < Rows; i++ )
+		{
+			Offs[ i ] = (int64_t) l;
+			Offs32[ i ] = (int32_t) l;
+			l += ( test_rand( 20 ) == 0 ? test_rand( 300 ) : test_rand( 40 ));
+		}
+
+		Offs[ Rows ] = (int64_t) l;
+		Offs32[ Rows ] = (int32_t) l;
+
+		uint8_t* const Data = (uint8_t*) malloc( l + 1 );
+
+		if( Data == 0 )
+		{
+			return( 1 );
+		}
+
+		test_fill( Data, l );
+		test_fill( Validity, sizeof( Validity ));
+
+		komihash_column_strings( Data, Offs, Rows, Seed, out );
+
+		for( i = 0; i < Rows; i++ )
+		{
+			if( out[ i ] != komihash( Data + Offs[ i ],
+				(size_t) ( Offs[ i + 1 ] - Offs[ i ]), Seed ))
+			{
+				free( Data );
+				return( 1 );
+			}
+		}
+
+		komihash_column_strings_v( Data, Offs, Rows, Seed, Validity,
+			NullHash, out );
+
+		for( i = 0; i < Rows; i++ )
+		{
+			if( out[ i ] != (( Validity[ i >> 3 ] >> ( i & 7 ) & 1 ) == 0 ?
+				NullHash : komihash( Data + Offs[ i ],
+				(size_t) ( Offs[ i + 1 ] - Offs[ i ]), Seed )))
+			{
+				free( Data );
+				return( 1 );
+			}
+		}
+
+		komihash_column_strings32_v( Data, Offs32, Rows, Seed,
+			( t % 2 == 0 ? Validity : 0 ), NullHash, out );
+
+		for( i = 0; i < Rows; i++ )
+		{
+			if( out[ i ] != ( t % 2 == 0 &&
+				( Validity[ i >> 3 ] >> ( i & 7 ) & 1 ) == 0 ? NullHash :
+				komihash( Data + Offs32[ i ],
+				(size_t) ( Offs32[ i + 1 ] - Offs32[ i ]), Seed )))
+			{
+				free( Data );
+				return( 1 );
+			}
+		}
+
+		free( Data );
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief Column folding (komihash_column_fold_i32/i64/f64/d128()) of four
+ * columns into the same row hashes, with random validity bitmaps, versus
+ * chained komihash() calls on values' little-endian representations, with
+ * each previous hash value used as the seed. Null values should be hashed as
+ * empty messages. Floating-point values include signed zeroes and NaNs with
+ * various payloads, which should be canonicalized.
+ */
+
+static int test_fold()
+{
+	static int32_t c32[ 300 ];
+	static int64_t c64[ 300 ];
+	static double cf[ 300 ];
+	static uint8_t cd[ 300 * 16 ];
+	static uint8_t Validity[ 4 ][ 38 ];
+	static uint64_t h[ 300 ];
+	int t, j, c;
+	size_t i;
+
+	for( t = 0; t < 300; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const size_t Rows = test_rand( 301 );
+		const int UseValidity = ( t % 3 != 0 );
+
+		for( i = 0; i < Rows; i++ )
+		{
+			uint64_t v = test_rand64();
+			c32[ i ] = (int32_t) (uint32_t) v;
+			c64[ i ] = (int64_t) test_rand64();
+
+			switch( test_rand( 4 ))
+			{
+				case 0:
+					v &= 0x8000000000000000; // Signed zero.
+					break;
+
+				case 1:
+					v |= 0x7FF0000000000001; // NaN.
+					break;
+			}
+
+			memcpy( cf + i, &v, 8 );
+			h[ i ] = Seed;
+		}
+
+		test_fill( cd, Rows * 16 );
+		test_fill( &Validity[ 0 ][ 0 ], sizeof( Validity ));
+
+		komihash_column_fold_i32( c32, Rows,
+			( UseValidity ? Validity[ 0 ] : 0 ), h );
+
+		komihash_column_fold_i64( c64, Rows,
+			( UseValidity ? Validity[ 1 ] : 0 ), h );
+
+		komihash_column_fold_f64( cf, Rows,
+			( UseValidity ? Validity[ 2 ] : 0 ), h );
+
+		komihash_column_fold_d128( cd, Rows,
+			( UseValidity ? Validity[ 3 ] : 0 ), h );
+
+		for( i = 0; i < Rows; i++ )
+		{
+			uint8_t le[ 3 ][ 8 ];
+			uint64_t e = Seed;
+			uint64_t fv;
+
+			if( cf[ i ] != cf[ i ])
+			{
+				fv = 0x7FF8000000000000;
+			}
+			else
+			if( cf[ i ] == 0.0 )
+			{
+				fv = 0;
+			}
+			else
+			{
+				memcpy( &fv, cf + i, 8 );
+			}
+
+			for( j = 0; j < 8; j++ )
+			{
+				le[ 0 ][ j ] = (uint8_t) ( (uint32_t) c32[ i ] >> ( j & 3 ) * 8 );
+				le[ 1 ][ j ] = (uint8_t) ( (uint64_t) c64[ i ] >> j * 8 );
+				le[ 2 ][ j ] = (uint8_t) ( fv >> j * 8 );
+			}
+
+			for( c = 0; c < 4; c++ )
+			{
+				const size_t l = ( c == 0 ? 4 : ( c == 3 ? 16 : 8 ));
+
+				if( UseValidity &&
+					( Validity[ c ][ i >> 3 ] >> ( i & 7 ) & 1 ) == 0 )
+				{
+					e = komihash( 0, 0, e );
+				}
+				else
+				{
+					e = komihash( ( c == 3 ? cd + i * 16 : le[ c ]), l, e );
+				}
+			}
+
+			if( h[ i ] != e )
+			{
+				return( 1 );
+			}
+		}
+	}
+
+	return( 0 );
+}
+
+#if defined( KOMIHASH_PTHREADS )
+
+/**
+ * @brief Multi-threaded tree hashing (komihash_tree_mt(), with 0-8 threads,
+ * and komihash_tree_mt_pool()), versus komihash_tree(), for lengths around
+ * leaf boundaries, and random lengths.
+ */
+
+static int test_tree()
+{
+	static uint8_t m[ KOMIHASH_TREE_LEAF * 5 + 1000 ];
+	static uint64_t lh[ KOMIHASH_TREE_LEAFCOUNT( sizeof( m ))];
+	komihash_pool_t pool;
+	int t, tc, r = 0;
+
+	test_fill( m, sizeof( m ));
+	komihash_pool_init( &pool, 4 );
+
+	for( t = 0; t < 30 && r == 0; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		size_t l = KOMIHASH_TREE_LEAF * (size_t) ( t / 6 ) + test_rand( 3 );
+		l = ( t % 2 == 0 ? ( l == 0 ? 0 : l - 1 ) : test_rand( sizeof( m ) + 1 ));
+
+		const uint64_t h = komihash_tree( m, l, Seed );
+
+		for( tc = 0; tc <= 8; tc++ )
+		{
+			if( komihash_tree_mt( m, l, Seed, lh, tc ) != h )
+			{
+				r = 1;
+			}
+		}
+
+		if( komihash_tree_mt_pool( m, l, Seed, lh, &pool ) != h )
+		{
+			r = 1;
+		}
+	}
+
+	komihash_pool_destroy( &pool );
+
+	return( r );
+}
+
+/**
+ * @brief Multi-threaded hashing of many messages (komihash_parallel_many(),
+ * with 0-8 threads, and komihash_parallel_many_pool()), versus komihash() of
+ * each message, for messages of random lengths (mostly short, with a few
+ * large ones), and random counts.
+ */
+
+static int test_many()
+{
+	static uint8_t m[ 300000 ];
+	static const void* Msgs[ 2000 ];
+	static size_t MsgLens[ 2000 ];
+	static size_t Order[ 2000 ];
+	static uint64_t out[ 2000 ];
+	komihash_pool_t pool;
+	int t, tc, r = 0;
+	size_t i;
+
+	test_fill( m, sizeof( m ));
+	komihash_pool_init( &pool, 4 );
+
+	for( t = 0; t < 30 && r == 0; t++ )
+	{
+		const uint64_t Seed = test_rand64();
+		const size_t n = test_rand( 2001 );
+
+		for( i = 0; i < n; i++ )
+		{
+			const size_t l = ( test_rand( 50 ) == 0 ?
+				test_rand( KOMIHASH_MANY_TASK * 2 ) : test_rand( 300 ));
+
+			Msgs[ i ] = m + test_rand( sizeof( m ) - l + 1 );
+			MsgLens[ i ] = l;
+		}
+
+		// Thread count 9 denotes the use of the thread pool.
+
+		for( tc = 0; tc <= 9; tc++ )
+		{
+			if( tc == 9 )
+			{
+				komihash_parallel_many_pool( Msgs, MsgLens, n, Seed, out,
+					Order, &pool );
+			}
+			else
+			{
+				komihash_parallel_many( Msgs, MsgLens, n, Seed, out, Order,
+					tc );
+			}
+
+			for( i = 0; i < n; i++ )
+			{
+				if( out[ i ] != komihash( Msgs[ i ], MsgLens[ i ], Seed ))
+				{
+					r = 1;
+				}
+			}
+		}
+	}
+
+	komihash_pool_destroy( &pool );
+
+	return( r );
+}
+
+#endif // defined( KOMIHASH_PTHREADS )
+
+/**
+ * @brief Typed appends (komihash_stream_update_u8/u16/u32/u64()), mixed with
+ * komihash_stream_update() calls, versus komihash_stream_update() calls with
+ * values' little-endian representations. Intermediate komihash_stream_final()
+ * calls check all buffer fill positions.
+ */
+
+static int test_typed()
+{
+	uint8_t m[ 40 ];
+	int t, i;
+
+	memset( m, 0, sizeof( m ));
+
+	for( t = 0; t < 300; t++ )
+	{
+		komihash_stream_t a, b;
+		komihash_stream_init( &a, t );
+		komihash_stream_init( &b, t );
+
+		const int n = (int) test_rand( 2000 );
+
+		for( i = 0; i < n; i++ )
+		{
+			const uint64_t v = komirand( &test_Seed1, &test_Seed2 );
+			uint8_t le[ 8 ];
+			int j;
+
+			for( j = 0; j < 8; j++ )
+			{
+				le[ j ] = (uint8_t) ( v >> j * 8 );
+			}
+
+			switch( test_rand( 5 ))
+			{
+				case 0:
+					komihash_stream_update_u8( &a, (uint8_t) v );
+					komihash_stream_update( &b, le, 1 );
+					break;
+
+				case 1:
+					komihash_stream_update_u16( &a, (uint16_t) v );
+					komihash_stream_update( &b, le, 2 );
+					break;
+
+				case 2:
+					komihash_stream_update_u32( &a, (uint32_t) v );
+					komihash_stream_update( &b, le, 4 );
+					break;
+
+				case 3:
+					komihash_stream_update_u64( &a, v );
+					komihash_stream_update( &b, le, 8 );
+					break;
+
+				default:
+				{
+					const size_t l = test_rand( sizeof( m ));
+
+					for( j = 0; j < (int) l; j++ )
+					{
+						m[ j ] = (uint8_t) test_rand( 256 );
+					}
+
+					komihash_stream_update( &a, m, l );
+					komihash_stream_update( &b, m, l );
+					break;
+				}
+			}
+
+			if( i % 97 == 0 &&
+				komihash_stream_final( &a ) != komihash_stream_final( &b ))
+			{
+				return( 1 );
+			}
+		}
+
+		if( komihash_stream_final( &a ) != komihash_stream_final( &b ))
+		{
+			return( 1 );
+		}
+	}
+
+#if defined( __cplusplus )
+
+	for( t = 0; t < 2; t++ )
+	{
+		komihash_stream_t a, b;
+		komihash_stream_init( &a, t );
+		komihash_stream_init( &b, t );
+
+		for( i = 0; i < 500; i++ )
+		{
+			komihash_stream_update_n< 12 >( &a, m + i % 20 );
+			komihash_stream_update( &b, m + i % 20, 12 );
+		}
+
+		if( komihash_stream_final( &a ) != komihash_stream_final( &b ))
+		{
+			return( 1 );
+		}
+	}
+
+#endif // defined( __cplusplus )
+
+	return( 0 );
+}
+
+/**
+ * @brief Streamed hashing, checkpointed at a random position via the
+ * komihash_stream_save() function, and resumed via the
+ * komihash_stream_load() function, versus komihash(). Truncated blobs, and
+ * blobs of an unsupported version, should be rejected.
+ */
+
+static int test_save()
+{
+	static uint8_t m[ 5000 ];
+	static uint8_t Blob[ KOMIHASH_SAVE_MAXLEN ];
+	size_t i;
+	int t;
+
+	for( i = 0; i < sizeof( m ); i++ )
+	{
+		m[ i ] = (uint8_t) test_rand( 256 );
+	}
+
+	for( t = 0; t < 2000; t++ )
+	{
+		const size_t l = test_rand( sizeof( m ) + 1 );
+		const size_t Cut = test_rand( l + 1 );
+		komihash_stream_t a, b;
+		size_t p = 0;
+
+		komihash_stream_init( &a, t );
+
+		while( p < Cut )
+		{
+			size_t q = test_rand( 300 );
+			q = ( q > Cut - p ? Cut - p : q );
+
+			komihash_stream_update( &a, m + p, q );
+			p += q;
+		}
+
+		const size_t BlobLen = komihash_stream_save( &a, Blob );
+
+		if( BlobLen > KOMIHASH_SAVE_MAXLEN ||
+			komihash_stream_load( &b, Blob, BlobLen - 1 ) != 0 )
+		{
+			return( 1 );
+		}
+
+		memset( &b, 0xAB, sizeof( b ));
+
+		if( komihash_stream_load( &b, Blob, BlobLen ) != 1 )
+		{
+			return( 1 );
+		}
+
+		while( p < l )
+		{
+			size_t q = test_rand( 300 );
+			q = ( q > l - p ? l - p : q );
+
+			komihash_stream_update( &b, m + p, q );
+			p += q;
+		}
+
+		if( komihash_stream_final( &b ) != komihash( m, l, t ))
+		{
+			return( 1 );
+		}
+
+		Blob[ 3 ] = KOMIHASH_SAVE_VER + 1;
+
+		if( komihash_stream_load( &b, Blob, BlobLen ) != 0 )
+		{
+			return( 1 );
+		}
+	}
+
+	return( 0 );
+}
+
+/**
+ * @brief Prefix-state hashing (komihash_from_prefix()) of random prefix and
+ * suffix lengths, and hashing of several prefixes (komihash_prefixes()) with
+ * sorted and unsorted cut points, versus komihash().
+ */
+
+static int test_prefix()
+{
+	static uint8_t m[ 2000 ];
+	uint8_t Suffix[ 300 ];
+	size_t Cuts[ 32 ];
+	uint64_t h[ 32 ];
+	size_t i, j;
+	int t;
+
+	for( i = 0; i < sizeof( m ); i++ )
+	{
+		m[ i ] = (uint8_t) test_rand( 256 );
+	}
+
+	for( t = 0; t < 3000; t++ )
+	{
+		const size_t pl = test_rand( 700 );
+		const size_t sl = test_rand( sizeof( Suffix ) + 1 );
+		komihash_prefix_t ps;
+
+		komihash_prefix_init( &ps, m, pl, t );
+
+		// The suffix is hashed from a separate buffer, to check that it is
+		// not read from beyond the prefix.
+
+		memcpy( Suffix, m + pl, sl );
+
+		if( komihash_from_prefix( &ps, Suffix, sl ) !=
+			komihash( m, pl + sl, t ))
+		{
+			return( 1 );
+		}
+	}
+
+	for( t = 0; t < 3000; t++ )
+	{
+		const size_t l = test_rand( sizeof( m ) + 1 );
+		const size_t n = test_rand( 33 );
+
+		for( i = 0; i < n; i++ )
+		{
+			Cuts[ i ] = test_rand( l + 20 );
+		}
+
+		// Cut points are sorted for the half of the tests.
+
+		for( i = 1; i < n && t % 2 == 0; i++ )
+		{
+			for( j = i; j > 0 && Cuts[ j - 1 ] > Cuts[ j ]; j-- )
+			{
+				const size_t c = Cuts[ j ];
+				Cuts[ j ] = Cuts[ j - 1 ];
+				Cuts[ j - 1 ] = c;
+			}
+		}
+
+		komihash_prefixes( m, l, Cuts, n, t, h );
+
+		for( i = 0; i < n; i++ )
+		{
+			if( h[ i ] != komihash( m, ( Cuts[ i ] < l ? Cuts[ i ] : l ), t ))
+			{
+				return( 1 );
+			}
+		}
+	}
+
+	return( 0 );
+}
+
+typedef struct {
+	const char* Name; ///< Test's name.
+	int ( *Func )(); ///< Test's function, returns 0 on success.
+} test_t;
+
+int main()
+{
+	const test_t tests[] = {
+		{ "key", test_key },
+		{ "fixed", test_fixed },
+		{ "padded", test_padded },
+		{ "mb", test_mb },
+		{ "cstream", test_cstream },
+#if defined( KOMIHASH_IOV )
+		{ "iov", test_iov },
+#endif // defined( KOMIHASH_IOV )
+		{ "bulk", test_bulk },
+		{ "ci", test_ci },
+		{ "wide", test_wide },
+		{ "h128", test_h128 },
+		{ "multi", test_multi },
+		{ "ptrs", test_ptrs },
+		{ "strided", test_strided },
+		{ "colstr", test_colstr },
+		{ "fold", test_fold },
+#if defined( KOMIHASH_PTHREADS )
+		{ "tree", test_tree },
+		{ "many", test_many },
+#endif // defined( KOMIHASH_PTHREADS )
+		{ "typed", test_typed },
+		{ "save", test_save },
+		{ "prefix", test_prefix }
+	};
+
+	const int testc = (int) ( sizeof( tests ) / sizeof( tests[ 0 ]));
+	int i;
+
+	for( i = 0; i < testc; i++ )
+	{
+		if( tests[ i ].Func() != 0 )
+		{
+			printf( "%s: FAILED\n", tests[ i ].Name );
+			return( 1 );
+		}
+
+		printf( "%s: passed\n", tests[ i ].Name );
+	}
+
+	return( 0 );
+}
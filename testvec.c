@@ -1,5 +1,5 @@
 /**
- * testvec.c version 5.9
+ * testvec.c version 5.11
  *
  * The program that lists test vectors and their hash values, for the current
  * version of komihash. Also prints initial outputs of the `komirand` PRNG.
@@ -83,6 +83,78 @@ int main()
 		printf( "\n" );
 	}
 
+	uint64_t h128[ 2 ];
+
+	for( j = 0; j < seedc; j++ )
+	{
+		printf( "komihash128 UseSeed = 0x%016llx:\n", seeds[ j ]);
+
+		for( i = 0; i < strc; i++ )
+		{
+			const char* const s = strs[ i ];
+			const size_t sl = strlen( s );
+
+			komihash128( s, sl, seeds[ j ], h128 );
+			printf( "\"%s\" = 0x%016llx%016llx\n", s, h128[ 1 ], h128[ 0 ]);
+		}
+
+		for( i = 0; i < bulkc; i++ )
+		{
+			komihash128( bulkbuf, bulks[ i ], seeds[ j ], h128 );
+			printf( "bulk(%i) = 0x%016llx%016llx\n", bulks[ i ], h128[ 1 ],
+				h128[ 0 ]);
+		}
+
+		printf( "\n" );
+	}
+
+	for( j = 0; j < seedc; j++ )
+	{
+		printf( "komihash_wide UseSeed = 0x%016llx:\n", seeds[ j ]);
+
+		for( i = 0; i < strc; i++ )
+		{
+			const char* const s = strs[ i ];
+			const size_t sl = strlen( s );
+
+			printf( "\"%s\" = 0x%016llx\n", s,
+				komihash_wide( s, sl, seeds[ j ]));
+		}
+
+		for( i = 0; i < bulkc; i++ )
+		{
+			printf( "bulk(%i) = 0x%016llx\n", bulks[ i ],
+				komihash_wide( bulkbuf, bulks[ i ], seeds[ j ]));
+		}
+
+		printf( "\n" );
+	}
+
+	#define treec 6
+	const size_t trees[ treec ] = { 0, 3, 256, 1048576, 1048577, 3145828 };
+
+	#define treebc 3145828
+	static uint8_t treebuf[ treebc ];
+	size_t k;
+
+	for( k = 0; k < treebc; k++ )
+	{
+		treebuf[ k ] = (uint8_t) k;
+	}
+
+	for( j = 0; j < seedc; j++ )
+	{
+		printf( "komihash_tree UseSeed = 0x%016llx:\n", seeds[ j ]);
+
+		for( i = 0; i < treec; i++ )
+		{
+			printf( "tree(%i) = 0x%016llx\n", (int) trees[ i ],
+				komihash_tree( treebuf, trees[ i ], seeds[ j ]));
+		}
+
+		printf( "\n" );
+	}
+
 	for( j = 0; j < seedc; j++ )
 	{
 		printf( "komirand Seed1/Seed2 = 0x%016llx:\n", seeds[ j ]);